@@ -10,6 +10,7 @@ public class HeraTarget : TargetRules
 		Type = TargetType.Game;
 		DefaultBuildSettings = BuildSettingsVersion.V2;
 		IncludeOrderVersion = EngineIncludeOrderVersion.Unreal5_1;
+		bWithPushModel = true;
 		ExtraModuleNames.Add("Hera");
 	}
 }
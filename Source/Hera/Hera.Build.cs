@@ -16,7 +16,11 @@ public class Hera : ModuleRules
 			"EnhancedInput",
 			"GameplayAbilities",
 			"GameplayTags",
-			"GameplayTasks"
+			"GameplayTasks",
+			"NetCore",
+			"Slate",
+			"SlateCore",
+			"UMG"
 		});
 
 		PublicIncludePaths.AddRange(new string[] 
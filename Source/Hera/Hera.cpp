@@ -1,7 +1,15 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "Hera.h"
+#include "core/hera_stats.h"
 #include "Modules/ModuleManager.h"
 
+DEFINE_STAT(STAT_Hera_HitsPerFrame);
+DEFINE_STAT(STAT_Hera_KillsPerFrame);
+DEFINE_STAT(STAT_Hera_ProjectilesAlive);
+DEFINE_STAT(STAT_Hera_ProjectilesSimulated);
+
+CSV_DEFINE_CATEGORY_MODULE(HERA_API, Hera, true);
+
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, Hera, "Hera" );
  
\ No newline at end of file
@@ -6,13 +6,17 @@
 #include "core/gas/abilities/base_ability.h"
 #include "core/gas/base_asc.h"
 #include "core/gas/tags.h"
+#include "core/subsystems/cosmetic_feedback_subsystem.h"
+#include "core/subsystems/healthbar_subsystem.h"
 #include "core/ui/healthbar_widget.h"
 #include "core/base_player_controller.h"
+#include "core/hera_stats.h"
 
 #include "Animation/AnimInstance.h"
 #include "Camera/CameraComponent.h"
 #include "Components/CapsuleComponent.h"
 #include "Components/WidgetComponent.h"
+#include "Engine/AssetManager.h"
 #include "GameFramework/SpringArmComponent.h"
 #include "EnhancedInputComponent.h"
 #include "EnhancedInputSubsystems.h"
@@ -20,12 +24,24 @@
 #include "Kismet/GameplayStatics.h"
 #include "GameFramework/CharacterMovementComponent.h"
 
+DECLARE_CYCLE_STAT(TEXT("InitializeFloatingHealthbar"), STAT_Hera_InitializeFloatingHealthbar, STATGROUP_Hera);
+
+/// Where the first person camera sits on the capsule.
+static const FVector kFirstPersonCameraOffset(-10.f, 0.f, 60.f);
+
 //---------------------------------------------------------------------------------------------------------------------
 /// MARK: - Character
 //---------------------------------------------------------------------------------------------------------------------
 
-ACharacterBase::ACharacterBase()
-	: IsCameraChangeAllowed(true)
+const FName ACharacterBase::kFirstPersonCameraName(TEXT("FPV Camera"));
+const FName ACharacterBase::kThirdPersonCameraBoomName(TEXT("TPV Camera Boom"));
+const FName ACharacterBase::kThirdPersonCameraName(TEXT("TPV Camera"));
+const FName ACharacterBase::kMesh1PName(TEXT("CharacterMesh1P"));
+const FName ACharacterBase::kFloatingHealthbarName(TEXT("Floating Healthbar Widget"));
+
+ACharacterBase::ACharacterBase(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+	, IsCameraChangeAllowed(true)
 	, bCameraIsChangingPov(false)
 	, bHasRifle(false)
 	, bCameraIsFirstPerson(true)
@@ -33,58 +49,77 @@ ACharacterBase::ACharacterBase()
 	// Set size for collision capsule
 	GetCapsuleComponent()->InitCapsuleSize(55.f, 96.0f);
 		
+	// Cameras, the first person mesh and the healthbar only matter where someone looks at the character. Whether
+	// the process is a dedicated server never changes, so the class defaults and every instance agree on it.
+	if (IsRunningDedicatedServer())
+	{
+		ObjectInitializer
+			.DoNotCreateDefaultSubobject(kFirstPersonCameraName)
+			.DoNotCreateDefaultSubobject(kThirdPersonCameraBoomName)
+			.DoNotCreateDefaultSubobject(kThirdPersonCameraName)
+			.DoNotCreateDefaultSubobject(kMesh1PName)
+			.DoNotCreateDefaultSubobject(kFloatingHealthbarName);
+	}
+
 	// Create a CameraComponents
-	FirstPersonCameraComponent = CreateDefaultSubobject<UCameraComponent>(TEXT("FPV Camera"));
-	FirstPersonCameraComponent->SetupAttachment(GetCapsuleComponent());
-	FirstPersonCameraComponent->SetRelativeLocation(FVector(-10.f, 0.f, 60.f));
-	FirstPersonCameraComponent->bUsePawnControlRotation = true;
-	FirstPersonCameraComponent->SetFieldOfView(90);
-	FirstPersonCameraComponent->SetAutoActivate(true);
+	FirstPersonCameraComponent = CreateOptionalDefaultSubobject<UCameraComponent>(kFirstPersonCameraName);
+	if (FirstPersonCameraComponent)
+	{
+		FirstPersonCameraComponent->SetupAttachment(GetCapsuleComponent());
+		FirstPersonCameraComponent->SetRelativeLocation(kFirstPersonCameraOffset);
+		FirstPersonCameraComponent->bUsePawnControlRotation = true;
+		FirstPersonCameraComponent->SetFieldOfView(90);
+		FirstPersonCameraComponent->SetAutoActivate(true);
+	}
 	
-	ThirdPersonCameraBoom = CreateDefaultSubobject<USpringArmComponent>(TEXT("TPV Camera Boom"));
-	ThirdPersonCameraBoom->SetupAttachment(GetCapsuleComponent());
-	ThirdPersonCameraBoom->SetRelativeLocation(FVector(-10.f, 0.f, 60.f));
-	ThirdPersonCameraBoom->bUsePawnControlRotation = true;
-	ThirdPersonCameraBoom->TargetArmLength = 400.f;
+	ThirdPersonCameraBoom = CreateOptionalDefaultSubobject<USpringArmComponent>(kThirdPersonCameraBoomName);
+	if (ThirdPersonCameraBoom)
+	{
+		ThirdPersonCameraBoom->SetupAttachment(GetCapsuleComponent());
+		ThirdPersonCameraBoom->SetRelativeLocation(kFirstPersonCameraOffset);
+		ThirdPersonCameraBoom->bUsePawnControlRotation = true;
+		ThirdPersonCameraBoom->TargetArmLength = 400.f;
+	}
 	
-	ThirdPersonCameraComponent = CreateDefaultSubobject<UCameraComponent>(TEXT("TPV Camera"));
-	ThirdPersonCameraComponent->SetupAttachment(ThirdPersonCameraBoom);
-	ThirdPersonCameraComponent->SetRelativeLocation(FVector(0.f, 0.f, 0.f));
-	ThirdPersonCameraComponent->bUsePawnControlRotation = true;
-	ThirdPersonCameraComponent->SetFieldOfView(90);
-	ThirdPersonCameraComponent->SetAutoActivate(true);
+	ThirdPersonCameraComponent = CreateOptionalDefaultSubobject<UCameraComponent>(kThirdPersonCameraName);
+	if (ThirdPersonCameraComponent)
+	{
+		ThirdPersonCameraComponent->SetupAttachment(ThirdPersonCameraBoom ? ThirdPersonCameraBoom.Get() : GetCapsuleComponent());
+		ThirdPersonCameraComponent->SetRelativeLocation(FVector(0.f, 0.f, 0.f));
+		ThirdPersonCameraComponent->bUsePawnControlRotation = true;
+		ThirdPersonCameraComponent->SetFieldOfView(90);
+		ThirdPersonCameraComponent->SetAutoActivate(true);
+	}
 
 	// Create a mesh component that will be used when being viewed from a '1st person' view (when controlling this pawn)
-	Mesh1P = CreateDefaultSubobject<USkeletalMeshComponent>(TEXT("CharacterMesh1P"));
-	Mesh1P->SetOnlyOwnerSee(true);
-	Mesh1P->SetupAttachment(FirstPersonCameraComponent);
-	Mesh1P->bCastDynamicShadow = false;
-	Mesh1P->CastShadow = false;
-	//Mesh1P->SetRelativeRotation(FRotator(0.9f, -19.19f, 5.2f));
-	Mesh1P->SetRelativeLocation(FVector(-30.f, 0.f, -150.f));
-
-	float CapsuleHalfHeight = GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
-	FloatingHealthbarComponent = CreateDefaultSubobject<UWidgetComponent>(FName("Floating Healthbar Widget"));
-	FloatingHealthbarComponent->SetupAttachment(RootComponent);
-	FloatingHealthbarComponent->SetRelativeLocation(FVector(0, 0, CapsuleHalfHeight)); // Top of the capsule
-	FloatingHealthbarComponent->SetWidgetSpace(EWidgetSpace::Screen);
-	FloatingHealthbarComponent->SetDrawSize(FVector2D(500, 500));
-
-	HealthbarWidgetClass = StaticLoadClass(
-		UObject::StaticClass(), 
-		nullptr,
-		TEXT("/Game/Hera/UI/UMG_Healthbar.UMG_Healthbar_C")
-	);
-	if (!HealthbarWidgetClass)
+	Mesh1P = CreateOptionalDefaultSubobject<USkeletalMeshComponent>(kMesh1PName);
+	if (Mesh1P)
 	{
-		UE_LOG(
-			LogTemp, 
-			Error, 
-			TEXT("%s() Failed to find HealthbarWidgetClass. If it was moved please update the reference location in C++."),
-			*FString(__FUNCTION__)
-		);
+		Mesh1P->SetOnlyOwnerSee(true);
+		Mesh1P->SetupAttachment(FirstPersonCameraComponent ? FirstPersonCameraComponent.Get() : GetCapsuleComponent());
+		Mesh1P->bCastDynamicShadow = false;
+		Mesh1P->CastShadow = false;
+		//Mesh1P->SetRelativeRotation(FRotator(0.9f, -19.19f, 5.2f));
+		Mesh1P->SetRelativeLocation(FVector(-30.f, 0.f, -150.f));
+	}
+
+	FloatingHealthbarComponent = CreateOptionalDefaultSubobject<UWidgetComponent>(kFloatingHealthbarName);
+	if (FloatingHealthbarComponent)
+	{
+		float CapsuleHalfHeight = GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+		FloatingHealthbarComponent->SetupAttachment(RootComponent);
+		FloatingHealthbarComponent->SetRelativeLocation(FVector(0, 0, CapsuleHalfHeight)); // Top of the capsule
+		FloatingHealthbarComponent->SetWidgetSpace(EWidgetSpace::Screen);
+		FloatingHealthbarComponent->SetDrawSize(FVector2D(500, 500));
 	}
 
+	// Without a camera the eyes are where the camera would be
+	BaseEyeHeight = kFirstPersonCameraOffset.Z;
+
+	HealthbarWidgetClass = TSoftClassPtr<UHealthbarWidget>(
+		FSoftClassPath(TEXT("/Game/Hera/UI/UMG_Healthbar.UMG_Healthbar_C"))
+	);
+
 	AbilitySystemComponent = CreateDefaultSubobject<UAbilitySystemComponentBase>("AbilitySystemComponent");
 	AbilitySystemComponent->SetIsReplicated(true);
 	AbilitySystemComponent->SetReplicationMode(EGameplayEffectReplicationMode::Mixed);
@@ -103,6 +138,21 @@ void ACharacterBase::BeginPlay()
 	// When the player is a client, the floating healthbars are all set up in OnRep_PlayerState.
 	InitializeFloatingHealthbar();
 
+	// The server remembers where we were so hits can be checked at the shooter's time
+	if (HasAuthority())
+	{
+		if (auto LagCompensation = GetWorld()->GetSubsystem<ULagCompensationSubsystem>())
+		{
+			LagCompensation->Register(this);
+		}
+	}
+
+	// Characters that matter less to the local player update less
+	if (auto SignificanceSubsystem = GetWorld()->GetSubsystem<USignificanceSubsystem>())
+	{
+		SignificanceSubsystem->Register(this);
+	}
+
 	//Add Input Mapping Context
 	if (auto PlayerController = Cast<APlayerControllerBase>(Controller))
 	{
@@ -116,6 +166,28 @@ void ACharacterBase::BeginPlay()
 	}
 }
 
+void ACharacterBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	const auto World = GetWorld();
+	if (auto LagCompensation = World ? World->GetSubsystem<ULagCompensationSubsystem>() : nullptr)
+	{
+		LagCompensation->Unregister(this);
+	}
+
+	if (auto SignificanceSubsystem = World ? World->GetSubsystem<USignificanceSubsystem>() : nullptr)
+	{
+		SignificanceSubsystem->Unregister(this);
+	}
+
+	UnbindLifeAttributes();
+	if (auto Healthbars = World ? World->GetSubsystem<UHealthbarSubsystem>() : nullptr)
+	{
+		Healthbars->Unregister(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 // Server-only
 void ACharacterBase::PossessedBy(AController* NewController)
 {
@@ -167,6 +239,74 @@ void ACharacterBase::OnMovementModeChanged(EMovementMode PrevMovementMode, uint8
 	}
 }
 
+//---------------------------------------------------------------------------------------------------------------------
+/// MARK: - Weapon
+//---------------------------------------------------------------------------------------------------------------------
+
+void ACharacterBase::MulticastProjectilesSpawned_Implementation(const TArray<FProjectileSpawnEvent>& Events)
+{
+	// The server flies the real projectiles and the shooter launched their own when they fired
+	if (HasAuthority() || IsLocallyControlled())
+	{
+		return;
+	}
+
+	if (auto ProjectileSim = GetWorld()->GetSubsystem<UProjectileSimSubsystem>())
+	{
+		for (const auto& Event : Events)
+		{
+			ProjectileSim->LaunchFromSpawnEvent(Event, this);
+		}
+	}
+
+	// The shooter heard their own shots when they fired. Everyone else hears them with the projectiles.
+	if (EquippedWeapon)
+	{
+		EquippedWeapon->ExecuteFireCue(Events.Num());
+	}
+}
+
+void ACharacterBase::ServerFireWeapon_Implementation(const FWeaponShotBatch& Batch)
+{
+	if (EquippedWeapon)
+	{
+		EquippedWeapon->FireBatchFromClient(Batch);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// MARK: - Significance
+//---------------------------------------------------------------------------------------------------------------------
+
+void ACharacterBase::SetSignificance(ESignificance NewSignificance)
+{
+	if (NewSignificance == Significance)
+	{
+		return;
+	}
+	Significance = NewSignificance;
+
+	const auto& Budget = FSignificanceBudget::Get(Significance);
+	SetActorTickInterval(Budget.TickInterval);
+
+	// The server's lag compensation records hit zones off the body's bones, so keep them current where it runs
+	if (!HasAuthority())
+	{
+		GetMesh()->SetComponentTickInterval(Budget.AnimationTickInterval);
+	}
+	if (Mesh1P)
+	{
+		Mesh1P->SetComponentTickInterval(Budget.AnimationTickInterval);
+	}
+
+	// Our own healthbar stays hidden. Batched healthbars check the significance themselves.
+	if (FloatingHealthbarComponent && FloatingHealthbarWidget && !IsLocallyControlled())
+	{
+		FloatingHealthbarComponent->SetComponentTickInterval(FMath::Max(Budget.HealthbarTickInterval, 0.0f));
+		FloatingHealthbarComponent->SetVisibility(Budget.HealthbarTickInterval >= 0.0f, true);
+	}
+}
+
 //---------------------------------------------------------------------------------------------------------------------
 /// MARK: - UI
 //---------------------------------------------------------------------------------------------------------------------
@@ -178,6 +318,8 @@ UHealthbarWidget* ACharacterBase::GetFloatingHealthbar()
 
 void ACharacterBase::InitializeFloatingHealthbar()
 {
+	HERA_SCOPE_CYCLE_COUNTER(InitializeFloatingHealthbar);
+
 	// Only create once
 	if (FloatingHealthbarWidget || !IsValid(AbilitySystemComponent))
 	{
@@ -198,20 +340,130 @@ void ACharacterBase::InitializeFloatingHealthbar()
 
 	// Setup UI for Locally Owned Players only, not AI or the server's copy of the PlayerControllers
 	auto PC = Cast<APlayerController>(UGameplayStatics::GetPlayerController(GetWorld(), 0));
-	if (PC && PC->IsLocalPlayerController())
+	if (!PC || !PC->IsLocalPlayerController())
+	{
+		return;
+	}
+
+	// Only widgets need the widget class. Come back once it's loaded.
+	const EHealthbarMode Mode = UHealthbarSubsystem::GetMode();
+	if (Mode != EHealthbarMode::Batched && HealthbarWidgetClass.IsPending())
+	{
+		if (!HealthbarWidgetClassHandle.IsValid())
+		{
+			HealthbarWidgetClassHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+				HealthbarWidgetClass.ToSoftObjectPath(),
+				FStreamableDelegate::CreateUObject(this, &ACharacterBase::InitializeFloatingHealthbar)
+			);
+			return;
+		}
+
+		if (HealthbarWidgetClassHandle->IsLoadingInProgress())
+		{
+			return;
+		}
+
+		UE_LOG(
+			LogTemp, 
+			Error, 
+			TEXT("%s() Failed to load HealthbarWidgetClass %s. If it was moved please update the reference."),
+			*FString(__FUNCTION__),
+			*HealthbarWidgetClass.ToString()
+		);
+	}
+
+	if (Mode != EHealthbarMode::PerActor)
 	{
-		if (HealthbarWidgetClass)
+		// The subsystem shows every bar. The widget component has nothing to show.
+		if (auto Healthbars = GetWorld()->GetSubsystem<UHealthbarSubsystem>())
 		{
-			// Creating a widget requires that the first arg be derived from one of the following:
-			// - UWidget, UWidgetTree, APlayerController, UGameInstance, UWorld
-			FloatingHealthbarWidget = CreateWidget<UHealthbarWidget>(PC, HealthbarWidgetClass);
-			if (FloatingHealthbarWidget && FloatingHealthbarComponent)
+			Healthbars->Register(this);
+			if (FloatingHealthbarComponent)
 			{
-				FloatingHealthbarWidget->SetOwningCharacter(this);
-				FloatingHealthbarComponent->SetWidget(FloatingHealthbarWidget);
+				FloatingHealthbarComponent->SetVisibility(false);
+				FloatingHealthbarComponent->SetComponentTickEnabled(false);
 			}
 		}
 	}
+	else if (HealthbarWidgetClass.Get())
+	{
+		// Creating a widget requires that the first arg be derived from one of the following:
+		// - UWidget, UWidgetTree, APlayerController, UGameInstance, UWorld
+		FloatingHealthbarWidget = CreateWidget<UHealthbarWidget>(PC, HealthbarWidgetClass.Get());
+		if (FloatingHealthbarWidget && FloatingHealthbarComponent)
+		{
+			FloatingHealthbarWidget->SetOwningCharacter(this);
+			FloatingHealthbarComponent->SetWidget(FloatingHealthbarWidget);
+		}
+	}
+
+	// From now on the healthbar only changes through UHealthbarSubsystem
+	HealthbarSnapshot = FHealthbarSnapshot::FromCharacter(this);
+	BindLifeAttributes();
+}
+
+void ACharacterBase::SetHealthbarSnapshot(const FHealthbarSnapshot& Snapshot)
+{
+	HealthbarSnapshot = Snapshot;
+	if (FloatingHealthbarWidget)
+	{
+		FloatingHealthbarWidget->ApplySnapshot(HealthbarSnapshot);
+	}
+}
+
+void ACharacterBase::BindLifeAttributes()
+{
+	if (IsLifeAttributesBound || !IsValid(AbilitySystemComponent))
+	{
+		return;
+	}
+	IsLifeAttributesBound = true;
+
+	for (const auto& Attribute : {
+		ULifeAttributeSet::GetHealthAttribute(),
+		ULifeAttributeSet::GetMaxHealthAttribute(),
+		ULifeAttributeSet::GetShieldsAttribute(),
+		ULifeAttributeSet::GetMaxShieldsAttribute(),
+		ULifeAttributeSet::GetArmorAttribute(),
+		ULifeAttributeSet::GetMaxArmorAttribute(),
+		ULifeAttributeSet::GetOverHealthAttribute(),
+		ULifeAttributeSet::GetOverArmorAttribute() })
+	{
+		AbilitySystemComponent->GetGameplayAttributeValueChangeDelegate(Attribute).AddUObject(
+			this, 
+			&ACharacterBase::OnLifeAttributeChanged
+		);
+	}
+}
+
+void ACharacterBase::UnbindLifeAttributes()
+{
+	if (!IsLifeAttributesBound || !IsValid(AbilitySystemComponent))
+	{
+		return;
+	}
+	IsLifeAttributesBound = false;
+
+	for (const auto& Attribute : {
+		ULifeAttributeSet::GetHealthAttribute(),
+		ULifeAttributeSet::GetMaxHealthAttribute(),
+		ULifeAttributeSet::GetShieldsAttribute(),
+		ULifeAttributeSet::GetMaxShieldsAttribute(),
+		ULifeAttributeSet::GetArmorAttribute(),
+		ULifeAttributeSet::GetMaxArmorAttribute(),
+		ULifeAttributeSet::GetOverHealthAttribute(),
+		ULifeAttributeSet::GetOverArmorAttribute() })
+	{
+		AbilitySystemComponent->GetGameplayAttributeValueChangeDelegate(Attribute).RemoveAll(this);
+	}
+}
+
+void ACharacterBase::OnLifeAttributeChanged(const FOnAttributeChangeData& Data)
+{
+	if (auto Healthbars = GetWorld()->GetSubsystem<UHealthbarSubsystem>())
+	{
+		Healthbars->MarkDirty(this);
+	}
 }
 
 //---------------------------------------------------------------------------------------------------------------------
@@ -223,6 +475,33 @@ class UAbilitySystemComponent* ACharacterBase::GetAbilitySystemComponent() const
 	return AbilitySystemComponent;
 }
 
+void ACharacterBase::HandleGameplayCue(
+	AActor* Self, 
+	FGameplayTag GameplayCueTag, 
+	EGameplayCueEvent::Type EventType, 
+	const FGameplayCueParameters& Parameters
+)
+{
+	if (GameplayCueTag == HeraTags::Tag_CueWeaponFire)
+	{
+		const auto Weapon = Cast<UTP_WeaponComponent>(Parameters.SourceObject.Get());
+		const auto CosmeticFeedback = GetWorld()->GetSubsystem<UCosmeticFeedbackSubsystem>();
+		const auto& Budget = FSignificanceBudget::Get(Significance);
+		if (EventType == EGameplayCueEvent::Executed && Weapon && CosmeticFeedback)
+		{
+			CosmeticFeedback->QueueFireFeedback(
+				Budget.PlayFireSound ? Weapon->FireSound.Get() : nullptr, 
+				Budget.PlayFireAnimation ? Weapon->FireAnimation.Get() : nullptr, 
+				Mesh1P, 
+				Parameters.Location
+			);
+		}
+		return;
+	}
+
+	IGameplayCueInterface::HandleGameplayCue(Self, GameplayCueTag, EventType, Parameters);
+}
+
 void ACharacterBase::GiveAbilities() 
 {
 	if (HasAuthority() && IsValid(AbilitySystemComponent))
@@ -485,8 +764,26 @@ bool ACharacterBase::GetHasRifle()
 /// MARK: - Camera
 //---------------------------------------------------------------------------------------------------------------------
 
+void ACharacterBase::GetAimViewPoint(FVector& OutLocation, FRotator& OutRotation) const
+{
+	OutLocation = FirstPersonCameraComponent 
+		? FirstPersonCameraComponent->GetComponentLocation() 
+		: GetActorTransform().TransformPosition(kFirstPersonCameraOffset);
+	OutRotation = GetBaseAimRotation();
+}
+
+USceneComponent* ACharacterBase::GetWeaponAttachParent() const
+{
+	return Mesh1P ? Mesh1P.Get() : static_cast<USceneComponent*>(GetMesh());
+}
+
 void ACharacterBase::SetCameraToFPV()
 {
+	if (!FirstPersonCameraComponent || !ThirdPersonCameraComponent)
+	{
+		return;
+	}
+
 	if (!bCameraIsFirstPerson)
 	{
 		bCameraIsFirstPerson = true;
@@ -497,6 +794,11 @@ void ACharacterBase::SetCameraToFPV()
 
 void ACharacterBase::SetCameraToTPV()
 {
+	if (!FirstPersonCameraComponent || !ThirdPersonCameraComponent)
+	{
+		return;
+	}
+
 	if (bCameraIsFirstPerson)
 	{
 		bCameraIsFirstPerson = false;
@@ -2,11 +2,21 @@
 
 #include "core/actors/projectile_actor.h"
 #include "core/debug_utils.h"
+#include "core/gas/base_asc.h"
+#include "core/hera_collision.h"
+#include "core/hera_stats.h"
+#include "core/subsystems/projectile_pool_subsystem.h"
 
 #include "GameFramework/ProjectileMovementComponent.h"
 #include "Components/SphereComponent.h"
+#include "Net/UnrealNetwork.h"
 // #include "Engine/World.h"
 
+DECLARE_CYCLE_STAT(TEXT("ProjectileHit"), STAT_Hera_ProjectileHit, STATGROUP_Hera);
+
+/// Live count for the CSV profiler, which has no accumulator stats of its own
+static int32 PROJECTILES_ALIVE = 0;
+
 AProjectileBase::AProjectileBase()
 {
 	ProjectileMovement = CreateDefaultSubobject<UProjectileMovementComponent>(FName("ProjectileMovement"));
@@ -20,14 +30,169 @@ AProjectileBase::AProjectileBase()
 	NetUpdateFrequency = 60.0f;
 }
 
+void AProjectileBase::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AProjectileBase, PoolState);
+}
+
+void AProjectileBase::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (IsVisualOnly)
+	{
+		// UProjectileSimSubsystem moves it and decides when it's done
+		SetLifeSpan(0.0f);
+		SetActorEnableCollision(false);
+		if (ProjectileMovement)
+		{
+			ProjectileMovement->Deactivate();
+		}
+	}
+	else if (!IsPooled())
+	{
+		// Pooled projectiles enter play when they're launched
+		SetInPlay(true);
+	}
+}
+
+void AProjectileBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	SetInPlay(false);
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AProjectileBase::LifeSpanExpired()
+{
+	Release();
+}
+
+void AProjectileBase::Release()
+{
+	if (!IsPooled())
+	{
+		Destroy();
+	}
+	else if (const auto OwningPool = Pool.Get())
+	{
+		OwningPool->Release(this);
+	}
+	else if (InPlay)
+	{
+		// A client's copy of a pooled projectile. Hide it now, the server retires it for real.
+		LeavePlay();
+	}
+}
+
+void AProjectileBase::Launch(const FVector& Location, const FRotator& Rotation)
+{
+	if (GetIsReplicated())
+	{
+		// Wake up before changing anything so the launch isn't lost to dormancy
+		SetNetDormancy(DORM_Awake);
+
+		PoolState.Location = Location;
+		PoolState.Direction = Rotation.Vector();
+		PoolState.LaunchCount++;
+		PoolState.IsActive = true;
+		ForceNetUpdate();
+	}
+
+	EnterPlay(Location, Rotation);
+	SetLifeSpan(GetClass()->GetDefaultObject<AProjectileBase>()->InitialLifeSpan);
+}
+
+void AProjectileBase::Retire()
+{
+	SetLifeSpan(0.0f);
+	EffectSpecHandle = FGameplayEffectSpecHandle();
+	LeavePlay();
+
+	if (GetIsReplicated())
+	{
+		PoolState.IsActive = false;
+
+		// Dormancy sends the inactive state before closing the channel, then costs nothing until the next launch
+		SetNetDormancy(DORM_DormantAll);
+	}
+}
+
+void AProjectileBase::EnterPlay(const FVector& Location, const FRotator& Rotation)
+{
+	SetActorLocationAndRotation(Location, Rotation, false, nullptr, ETeleportType::ResetPhysics);
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+
+	if (ProjectileMovement)
+	{
+		// A blocking hit clears the UpdatedComponent, so set it up again on every launch
+		ProjectileMovement->SetUpdatedComponent(GetRootComponent());
+		ProjectileMovement->Velocity = Rotation.Vector() * ProjectileMovement->InitialSpeed;
+		ProjectileMovement->UpdateComponentVelocity();
+		ProjectileMovement->Activate(true);
+	}
+
+	SetInPlay(true);
+}
+
+void AProjectileBase::LeavePlay()
+{
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+
+	if (ProjectileMovement)
+	{
+		ProjectileMovement->StopMovementImmediately();
+		ProjectileMovement->Deactivate();
+	}
+
+	SetInPlay(false);
+}
+
+void AProjectileBase::OnRep_PoolState()
+{
+	if (PoolState.IsActive)
+	{
+		// Also covers a relaunch that arrived without the inactive state in between
+		EnterPlay(PoolState.Location, PoolState.Direction.Rotation());
+	}
+	else if (InPlay)
+	{
+		LeavePlay();
+	}
+}
+
+void AProjectileBase::SetInPlay(bool NewInPlay)
+{
+	if (InPlay == NewInPlay)
+	{
+		return;
+	}
+
+	InPlay = NewInPlay;
+	if (InPlay)
+	{
+		INC_DWORD_STAT(STAT_Hera_ProjectilesAlive);
+		CSV_CUSTOM_STAT(Hera, ProjectilesAlive, ++PROJECTILES_ALIVE, ECsvCustomStatOp::Set);
+	}
+	else
+	{
+		DEC_DWORD_STAT(STAT_Hera_ProjectilesAlive);
+		CSV_CUSTOM_STAT(Hera, ProjectilesAlive, --PROJECTILES_ALIVE, ECsvCustomStatOp::Set);
+	}
+}
+
 AHeraProjectile::AHeraProjectile() 
 : AProjectileBase()
-, damage(10)
+, Damage(10.0f)
 {
 	// Use a sphere as a simple collision representation
 	CollisionComp = CreateDefaultSubobject<USphereComponent>(TEXT("SphereComp"));
 	CollisionComp->InitSphereRadius(5.0f);
-	CollisionComp->BodyInstance.SetCollisionProfileName("Projectile");
+	CollisionComp->BodyInstance.SetCollisionProfileName(HeraCollision::kProjectileProfile);
 	CollisionComp->OnComponentHit.AddDynamic(this, &AHeraProjectile::OnHit);		// set up a notification for when this component hits something blocking
 
 	// Players can't walk on it
@@ -55,11 +220,20 @@ void AHeraProjectile::OnHit(
 	const FHitResult& Hit
 )
 {
-	// Only add impulse and destroy projectile if we hit a physics
+	HERA_SCOPE_CYCLE_COUNTER(ProjectileHit);
+
+	// Hits on anything with an ASC only count on the authority. The spec is the weapon's, shared by all its shots.
+	if (HasAuthority() && OtherActor != nullptr && OtherActor != this && OtherActor != GetInstigator())
+	{
+		UAbilitySystemComponentBase::ApplyHitDamage(OtherActor, GetInstigator(), EffectSpecHandle, Damage);
+	}
+
+	// Only add impulse if we hit a physics
 	if ((OtherActor != nullptr) && (OtherActor != this) && (OtherComp != nullptr) && OtherComp->IsSimulatingPhysics())
 	{
 		OtherComp->AddImpulseAtLocation(GetVelocity() * 100.0f, GetActorLocation());
-
-		Destroy();
 	}
+
+	// Every blocking hit ends the flight. Back to the pool, or destroyed when it isn't pooled.
+	Release();
 }
@@ -5,131 +5,359 @@
 #include "core/actors/base_character_actor.h"
 #include "core/base_player_controller.h"
 #include "core/actors/projectile_actor.h"
+#include "core/subsystems/projectile_pool_subsystem.h"
+#include "core/subsystems/projectile_sim_subsystem.h"
+#include "core/subsystems/hitscan_subsystem.h"
+#include "core/data/weapon_definition.h"
+#include "core/gas/tags.h"
 #include "core/debug_utils.h"
+#include "core/hera_stats.h"
 
 #include "GameFramework/PlayerController.h"
 #include "Camera/PlayerCameraManager.h"
-#include "Kismet/GameplayStatics.h"
 #include "EnhancedInputComponent.h"
 #include "EnhancedInputSubsystems.h"
 #include "Camera/CameraComponent.h"
+#include "GameFramework/GameStateBase.h"
+#include "AbilitySystemComponent.h"
+#include "GameplayEffect.h"
+#include "Engine/AssetManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("WeaponFire"), STAT_Hera_WeaponFire, STATGROUP_Hera);
+
+/// Share of the rate of fire the server allows between a client's shots, for jitter in their timestamps.
+static constexpr float kFireRateTolerance = 0.9f;
+
+/// Furthest in cm a client's view can be from their character before the server uses its own.
+static constexpr float kMaxViewDistance = 300.0f;
+
+//---------------------------------------------------------------------------------------------------------------------
+/// MARK: - FFireScheduler
+//---------------------------------------------------------------------------------------------------------------------
+
+void FFireScheduler::PressTrigger(double Now)
+{
+	IsTriggerHeld = true;
+
+	// The first shot goes right away, unless the last one was too recent
+	NextShotTime = FMath::Max(NextShotTime, Now);
+}
+
+void FFireScheduler::ReleaseTrigger()
+{
+	IsTriggerHeld = false;
+}
+
+void FFireScheduler::Advance(double Now, int32 MaxShots, TArray<double>& OutShotTimes)
+{
+	OutShotTimes.Reset();
+	if (!IsTriggerHeld || ShotInterval <= 0.0 || NextShotTime > Now)
+	{
+		return;
+	}
+
+	// Every shot due by Now, but only the newest MaxShots of them are fired. The rest are skipped the same way
+	// whatever the frame rate, so a hitch never turns into a burst.
+	const int64 DueCount = FMath::FloorToInt64((Now - NextShotTime) / ShotInterval) + 1;
+	const int64 FiredCount = FMath::Min<int64>(DueCount, MaxShots);
+	for (int64 Shot = DueCount - FiredCount; Shot < DueCount; ++Shot)
+	{
+		OutShotTimes.Add(NextShotTime + Shot * ShotInterval);
+	}
+
+	NextShotTime += DueCount * ShotInterval;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// MARK: - UTP_WeaponComponent
+//---------------------------------------------------------------------------------------------------------------------
 
 // Sets default values for this component's properties
 UTP_WeaponComponent::UTP_WeaponComponent()
 {
 	// Default offset from the character location for projectiles to spawn
 	MuzzleOffset = FVector(100.0f, 0.0f, 10.0f);
+
+	// Only ticks while the trigger is held
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
 }
 
+void UTP_WeaponComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	UpdateFiring();
+}
+
+void UTP_WeaponComponent::StartFiring()
+{
+	if (Character == nullptr || !Character->IsLocallyControlled())
+	{
+		return;
+	}
+
+	FireScheduler.PressTrigger(GetWorld()->GetTimeSeconds());
+	SetComponentTickEnabled(true);
+	UpdateFiring();
+}
+
+void UTP_WeaponComponent::StopFiring()
+{
+	FireScheduler.ReleaseTrigger();
+	SetComponentTickEnabled(false);
+}
 
 void UTP_WeaponComponent::Fire()
+{
+	const TArray<double> ShotTimes = { GetWorld()->GetTimeSeconds() };
+	FireShots(ShotTimes);
+}
+
+void UTP_WeaponComponent::UpdateFiring()
+{
+	FireScheduler.ShotInterval = 60.0 / FMath::Max(RoundsPerMinute, 1.0f);
+	FireScheduler.Advance(GetWorld()->GetTimeSeconds(), MaxShotsPerFrame, DueShotTimes);
+
+	if (DueShotTimes.Num() > 0)
+	{
+		FireShots(DueShotTimes);
+	}
+}
+
+void UTP_WeaponComponent::FireShots(const TArray<double>& ShotTimes)
 {
 	if (Character == nullptr || Character->GetController() == nullptr)
 	{
 		return;
 	}
 
-	// Try and fire a projectile
-	if (ProjectileClass != nullptr)
+	FWeaponShotBatch Batch;
+	if (!MakeBatch(ShotTimes, Batch))
+	{
+		return;
+	}
+
+	// Fire our own copy right away, and the server fires the real one
+	FireBatch(Batch);
+	if (!Character->HasAuthority())
 	{
-		const auto  World = GetWorld();
-		if (World != nullptr)
+		Character->ServerFireWeapon(Batch);
+	}
+}
+
+bool UTP_WeaponComponent::MakeBatch(const TArray<double>& ShotTimes, FWeaponShotBatch& OutBatch) const
+{
+	const auto PlayerController = Cast<APlayerControllerBase>(Character->GetController());
+	const auto World = GetWorld();
+	if (World == nullptr || PlayerController == nullptr || PlayerController->PlayerCameraManager == nullptr)
+	{
+		return false;
+	}
+
+	const auto GameState = World->GetGameState();
+	const double Now = World->GetTimeSeconds();
+
+	OutBatch.ViewLocation = PlayerController->PlayerCameraManager->GetCameraLocation();
+	OutBatch.AimDirection = PlayerController->PlayerCameraManager->GetCameraRotation().Vector();
+	OutBatch.ServerTime = GameState ? GameState->GetServerWorldTimeSeconds() : Now;
+	OutBatch.FirstShot = ShotCount;
+
+	OutBatch.ShotAges.Reset(ShotTimes.Num());
+	for (const double ShotTime : ShotTimes)
+	{
+		OutBatch.ShotAges.Add(static_cast<uint16>(FMath::Clamp<int64>(FMath::RoundToInt64((Now - ShotTime) * 10000.0), 0, MAX_uint16)));
+	}
+
+	return true;
+}
+
+void UTP_WeaponComponent::FireBatchFromClient(const FWeaponShotBatch& Batch)
+{
+	const auto World = GetWorld();
+	if (World == nullptr || Character == nullptr || !Character->HasAuthority())
+	{
+		return;
+	}
+
+	// A client can't claim a shot from the future
+	const auto GameState = World->GetGameState();
+	const float ServerNow = GameState ? GameState->GetServerWorldTimeSeconds() : World->GetTimeSeconds();
+
+	FWeaponShotBatch Accepted = Batch;
+	Accepted.ServerTime = FMath::Min(Batch.ServerTime, ServerNow);
+	Accepted.ShotAges.Reset();
+
+	// Drop shots that come faster than the weapon fires, or more than it fires in a frame
+	const float ShotInterval = 60.0f / FMath::Max(RoundsPerMinute, 1.0f);
+	for (int32 Index = 0; Index < Batch.ShotAges.Num() && Accepted.ShotAges.Num() < MaxShotsPerFrame; ++Index)
+	{
+		const float ShotTime = Accepted.ServerTime - Batch.GetShotAge(Index);
+		if (ShotTime >= LastAcceptedShotTime + ShotInterval * kFireRateTolerance)
 		{
-			auto PlayerController = Cast<APlayerControllerBase>(Character->GetController());
-			const auto SpawnRotation = PlayerController->PlayerCameraManager->GetCameraRotation();
-			// MuzzleOffset is in camera space, so transform it to world space before offsetting from the character location to find the final muzzle position
-			const auto SpawnLocation = GetOwner()->GetActorLocation() + SpawnRotation.RotateVector(MuzzleOffset);
-			
-			// Set Spawn Collision Handling Override
-			FActorSpawnParameters ActorSpawnParams;
-			ActorSpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
-			
-			// Spawn the projectile at the muzzle
-			World->SpawnActor<AHeraProjectile>(
-				ProjectileClass, 
-				SpawnLocation, 
-				SpawnRotation, 	
-				ActorSpawnParams
-			);
-
-
-			// Do line trace for hitscan impact
-		// 	FColor DebugLineColor = FColor:: Blue;
-		// 	float TraceDistance = 10000.f; // centemeters
-		// 	float ImpulseForce = 500.f;
-		// 	const UCameraComponent& CharCam = *Character->GetFirstPersonCameraComponent();
-		// 	const FVector TraceStart = CharCam.GetComponentLocation();
-		// 	const FVector TraceEnd = TraceStart + CharCam.GetForwardVector() * TraceDistance;
-		// 	FHitResult Hit;
-		// 	const bool bDidHit = World->LineTraceSingleByChannel(
-		// 		Hit,											// Hit result of the trace
-		// 		TraceStart,									// Start vector
-		// 		TraceEnd,									// End vector
-		// 		ECollisionChannel::ECC_Visibility	// Collision channel
-		// 	);
-			
-		// 	if (bDidHit) 
-		// 	{
-		// 		if ((Hit.bBlockingHit == true) && (Hit.Component != nullptr))
-		// 		{
-		// 			UStaticMeshComponent* MeshComponent = Cast<UStaticMeshComponent>(Hit.GetActor()->GetRootComponent());
-					
-		// 			if (MeshComponent->IsSimulatingPhysics())
-		// 			{
-		// 				MeshComponent->AddImpulseAtLocation(
-		// 					CharCam.GetForwardVector() * ImpulseForce * MeshComponent->GetMass(), 
-		// 					Hit.ImpactPoint
-		// 				);
-						
-		// 				UHeraUtil::DebugPrint("Line trace hit physics object", DebugLineColor);
-		// 			}
-		// 			else 
-		// 			{
-		// 				DebugLineColor = FColor::White;
-		// 				UHeraUtil::DebugPrint("Line trace hit static object", DebugLineColor);
-		// 			}
-		// 		}
-		// 		else 
-		// 		{
-		// 			DebugLineColor = FColor::White;
-		// 			UHeraUtil::DebugPrint("Line trace succeeded but didn't make contact", DebugLineColor);
-		// 		}
-		// 	}
-		// 	else 
-		// 	{
-		// 		DebugLineColor = FColor::Red;
-		// 		UHeraUtil::DebugPrint("Line trace fail", DebugLineColor);
-		// 	}
-
-		// 	DrawDebugLine(
-		// 		World, 			// World
-		// 		TraceStart, 	// Start point
-		// 		TraceEnd, 		// End point
-		// 		DebugLineColor,// Color
-		// 		false, 			// Is it persistent?
-		// 		5.f, 				// LifeTime
-		// 		(uint8)0U, 
-		// 		0.5f				// Thickness
-		// 	);
+			Accepted.ShotAges.Add(Batch.ShotAges[Index]);
+			LastAcceptedShotTime = ShotTime;
 		}
 	}
-	
-	// Try and play the sound if specified
-	if (FireSound != nullptr)
+
+	if (Accepted.ShotAges.Num() == 0)
 	{
-		UGameplayStatics::PlaySoundAtLocation(this, FireSound, Character->GetActorLocation());
+		return;
 	}
-	
-	// Try and play a firing animation if specified
-	if (FireAnimation != nullptr)
+
+	// Shots come from the shooter's own eyes
+	if (FVector::DistSquared(Accepted.ViewLocation, Character->GetActorLocation()) > FMath::Square(kMaxViewDistance))
+	{
+		FVector AimLocation;
+		FRotator AimRotation;
+		Character->GetAimViewPoint(AimLocation, AimRotation);
+		Accepted.ViewLocation = AimLocation;
+	}
+
+	FireBatch(Accepted);
+}
+
+void UTP_WeaponComponent::FireBatch(const FWeaponShotBatch& Batch)
+{
+	HERA_SCOPE_CYCLE_COUNTER(WeaponFire);
+
+	const auto World = GetWorld();
+	const int32 NumShots = Batch.ShotAges.Num();
+	if (World == nullptr || Character == nullptr || NumShots == 0)
+	{
+		return;
+	}
+
+	// The ASC may not have been ready on equip
+	if (!DamageSpec.IsValid())
+	{
+		BuildDamageSpec();
+	}
+
+	const FVector AimDirection = Batch.AimDirection;
+	const FRotator AimRotation = AimDirection.Rotation();
+
+	// Shots that came from a client hit characters where that client saw them
+	const bool IsFromClient = Character->HasAuthority() && !Character->IsLocallyControlled();
+
+	if (FireMode == EWeaponFireMode::Hitscan)
+	{
+		// Traced with every other hitscan shot of the frame, and resolved next frame
+		if (auto Hitscan = World->GetSubsystem<UHitscanSubsystem>())
+		{
+			for (int32 Index = 0; Index < NumShots; ++Index)
+			{
+				FHitscanShot Shot;
+				Shot.Origin = Batch.ViewLocation;
+				Shot.Direction = AimDirection;
+				Shot.Range = HitscanRange;
+				Shot.PelletCount = PelletCount;
+				Shot.SpreadDegrees = PelletSpreadDegrees;
+				Shot.Seed = Batch.FirstShot + Index;
+				Shot.Instigator = Character;
+				Shot.EffectSpecHandle = DamageSpec;
+				Shot.DirectDamage = Damage;
+				Shot.ShooterTime = IsFromClient ? Batch.ServerTime - Batch.GetShotAge(Index) : -1.0f;
+				Hitscan->QueueShot(Shot);
+			}
+		}
+	}
+	else if (ProjectileClass != nullptr)
 	{
-		// Get the animation object for the arms mesh
-		auto AnimInstance = Character->GetMesh1P()->GetAnimInstance();
-		if (AnimInstance != nullptr)
+		// MuzzleOffset is in camera space, so transform it to world space before offsetting from the character location to find the final muzzle position
+		const auto SpawnLocation = GetOwner()->GetActorLocation() + AimRotation.RotateVector(MuzzleOffset);
+		
+		// Launch a projectile from the muzzle. Batched projectiles fly without an actor of their own, the others
+		// come from the pool, which reuses one that already hit or expired when it can. Batched shots fired earlier
+		// in the frame start as far along as they'd have flown since, sweeping the way there.
+		const auto ProjectileSim = World->GetSubsystem<UProjectileSimSubsystem>();
+		if (ProjectileSim && UProjectileSimSubsystem::ShouldSimulate(ProjectileClass, World))
+		{
+			const bool SendSpawnEvents = Character->HasAuthority() && UProjectileSimSubsystem::ShouldSendSpawnEvents(World);
+			TArray<FProjectileSpawnEvent> SpawnEvents;
+
+			for (int32 Index = 0; Index < NumShots; ++Index)
+			{
+				auto LaunchParams = FProjectileLaunchParams::FromClass(ProjectileClass, SpawnLocation, AimRotation);
+				LaunchParams.Instigator = Character;
+				LaunchParams.EffectSpecHandle = DamageSpec;
+				LaunchParams.DirectDamage = Damage;
+				ProjectileSim->Launch(LaunchParams, Batch.GetShotAge(Index));
+
+				if (SendSpawnEvents)
+				{
+					SpawnEvents.Add(ProjectileSim->MakeSpawnEvent(
+						ProjectileClass, 
+						LaunchParams, 
+						static_cast<uint16>(Batch.FirstShot + Index), 
+						Batch.GetShotAge(Index)
+					));
+				}
+			}
+
+			// Clients fly their own copies from one multicast instead of following replicated actors
+			if (SpawnEvents.Num() > 0)
+			{
+				Character->MulticastProjectilesSpawned(SpawnEvents);
+			}
+		}
+		else if (Character->HasAuthority())
 		{
-			AnimInstance->Montage_Play(FireAnimation, 1.f);
+			// Pooled projectiles are replicated actors. A client launching its own would see every shot twice.
+			// They all leave from the muzzle. Moving one ahead without a sweep would let it pass through walls.
+			if (auto ProjectilePool = World->GetSubsystem<UProjectilePoolSubsystem>())
+			{
+				for (int32 Index = 0; Index < NumShots; ++Index)
+				{
+					ProjectilePool->Acquire(
+						ProjectileClass, 
+						FTransform(AimRotation, SpawnLocation), 
+						Character, 
+						Character,
+						DamageSpec,
+						Damage
+					);
+				}
+			}
 		}
 	}
+
+	ShotCount = Batch.FirstShot + NumShots;
+	
+	// Sound and animation once for the whole frame, nothing to hear or see on a dedicated server
+	if (GetNetMode() != NM_DedicatedServer)
+	{
+		ExecuteFireCue(NumShots);
+	}
+}
+
+void UTP_WeaponComponent::ExecuteFireCue(int32 NumShots)
+{
+	const auto ASC = Character ? Character->GetAbilitySystemComponent() : nullptr;
+	if (!ASC || (FireSound == nullptr && FireAnimation == nullptr))
+	{
+		return;
+	}
+
+	FGameplayCueParameters Parameters;
+	Parameters.Location = Character->GetActorLocation();
+	Parameters.Instigator = Character;
+	Parameters.EffectCauser = Character;
+	Parameters.SourceObject = this;
+	Parameters.RawMagnitude = NumShots;
+	ASC->ExecuteGameplayCueLocal(HeraTags::Tag_CueWeaponFire, Parameters);
+}
+
+void UTP_WeaponComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Stream in what firing needs while the weapon waits to be picked up
+	if (Definition)
+	{
+		ApplyDefinitionSettings();
+		LoadDefinition(false);
+	}
 }
 
 void UTP_WeaponComponent::AttachWeapon(ACharacterBase* TargetCharacter)
@@ -142,35 +370,178 @@ void UTP_WeaponComponent::AttachWeapon(ACharacterBase* TargetCharacter)
 
 	// Attach the weapon to the First Person Character
 	FAttachmentTransformRules AttachmentRules(EAttachmentRule::SnapToTarget, true);
-	AttachToComponent(Character->GetMesh1P(), AttachmentRules, FName(TEXT("GripPoint")));
+	AttachToComponent(Character->GetWeaponAttachParent(), AttachmentRules, FName(TEXT("GripPoint")));
 	
 	// switch bHasRifle so the animation blueprint can switch to another animation set
 	Character->SetHasRifle(true);
+	Character->SetEquippedWeapon(this);
+
+	// The rest waits for the definition's assets. A dedicated server has no use for sounds, animations or input.
+	if (Definition)
+	{
+		LoadDefinition(GetNetMode() != NM_DedicatedServer);
+		return;
+	}
+
+	FinishEquip();
+}
+
+void UTP_WeaponComponent::FinishEquip()
+{
+	if (Character == nullptr)
+	{
+		return;
+	}
+
+	Damage = HitscanDamage;
+	if (FireMode == EWeaponFireMode::Projectile && ProjectileClass)
+	{
+		Damage = ProjectileClass->GetDefaultObject<AHeraProjectile>()->Damage;
+	}
+	BuildDamageSpec();
+
+	// Have projectiles ready before the first shot. Batched projectiles don't need actors, and clients get
+	// pooled ones from the server.
+	const auto World = GetWorld();
+	const auto ProjectilePool = World && Character->HasAuthority() ? World->GetSubsystem<UProjectilePoolSubsystem>() : nullptr;
+	if (ProjectilePool && FireMode == EWeaponFireMode::Projectile && !UProjectileSimSubsystem::ShouldSimulate(ProjectileClass, World))
+	{
+		ProjectilePool->Prewarm(ProjectileClass);
+	}
+
+	BindFireInput();
+}
+
+void UTP_WeaponComponent::BindFireInput()
+{
+	auto PlayerController = Cast<APlayerControllerBase>(Character->GetController());
+	if (IsFireInputBound || PlayerController == nullptr || FireMappingContext == nullptr || FireAction == nullptr)
+	{
+		return;
+	}
 
 	// Set up action bindings
-	if (auto PlayerController = Cast<APlayerControllerBase>(Character->GetController()))
+	if (UEnhancedInputLocalPlayerSubsystem* Subsystem = ULocalPlayer::GetSubsystem<UEnhancedInputLocalPlayerSubsystem>(PlayerController->GetLocalPlayer()))
 	{
-		if (UEnhancedInputLocalPlayerSubsystem* Subsystem = ULocalPlayer::GetSubsystem<UEnhancedInputLocalPlayerSubsystem>(PlayerController->GetLocalPlayer()))
-		{
-			// Set the priority of the mapping to 1, so that it overrides the Jump action with the Fire action when using touch input
-			Subsystem->AddMappingContext(FireMappingContext, 1);
-		}
+		// Set the priority of the mapping to 1, so that it overrides the Jump action with the Fire action when using touch input
+		Subsystem->AddMappingContext(FireMappingContext, 1);
+	}
 
-		if (UEnhancedInputComponent* EnhancedInputComponent = Cast<UEnhancedInputComponent>(PlayerController->InputComponent))
-		{
-			// Fire
-			EnhancedInputComponent->BindAction(
-				FireAction,
-				ETriggerEvent::Triggered, 
-				this, 
-				&UTP_WeaponComponent::Fire
-			);
-		}
+	if (UEnhancedInputComponent* EnhancedInputComponent = Cast<UEnhancedInputComponent>(PlayerController->InputComponent))
+	{
+		// Fire at RoundsPerMinute for as long as the trigger is held, however often input is polled
+		EnhancedInputComponent->BindAction(
+			FireAction,
+			ETriggerEvent::Started, 
+			this, 
+			&UTP_WeaponComponent::StartFiring
+		);
+		EnhancedInputComponent->BindAction(FireAction, ETriggerEvent::Completed, this, &UTP_WeaponComponent::StopFiring);
+		EnhancedInputComponent->BindAction(FireAction, ETriggerEvent::Canceled, this, &UTP_WeaponComponent::StopFiring);
+		IsFireInputBound = true;
+	}
+}
+
+void UTP_WeaponComponent::LoadDefinition(bool WithClientAssets)
+{
+	TArray<FName> Bundles = { UWeaponDefinition::kGameplayBundle };
+	if (WithClientAssets)
+	{
+		Bundles.Add(UWeaponDefinition::kClientBundle);
+	}
+
+	const FPrimaryAssetId AssetId = Definition->GetPrimaryAssetId();
+	if (!UAssetManager::Get().GetPrimaryAssetPath(AssetId).IsValid())
+	{
+		UE_LOG(
+			LogTemp, 
+			Error, 
+			TEXT("%s() %s isn't a known primary asset. Weapon definitions need to be under /Game/Hera/Data."),
+			*FString(__FUNCTION__),
+			*AssetId.ToString()
+		);
+		return;
+	}
+
+	DefinitionHandle = UAssetManager::Get().LoadPrimaryAsset(
+		AssetId, 
+		Bundles, 
+		FStreamableDelegate::CreateUObject(this, &UTP_WeaponComponent::OnDefinitionLoaded)
+	);
+
+	// Everything was already in memory
+	if (!DefinitionHandle.IsValid())
+	{
+		OnDefinitionLoaded();
+	}
+}
+
+void UTP_WeaponComponent::OnDefinitionLoaded()
+{
+	if (Definition == nullptr)
+	{
+		return;
+	}
+
+	// Whatever isn't loaded stays null, like the client assets on a dedicated server
+	DamageEffectClass = Definition->DamageEffectClass.Get();
+	ProjectileClass = Definition->ProjectileClass.Get();
+	FireSound = Definition->FireSound.Get();
+	FireAnimation = Definition->FireAnimation.Get();
+	FireMappingContext = Definition->FireMappingContext.Get();
+	FireAction = Definition->FireAction.Get();
+
+	FinishEquip();
+}
+
+void UTP_WeaponComponent::ApplyDefinitionSettings()
+{
+	FireMode = Definition->FireMode;
+	RoundsPerMinute = Definition->RoundsPerMinute;
+	MaxShotsPerFrame = Definition->MaxShotsPerFrame;
+	HitscanRange = Definition->HitscanRange;
+	PelletCount = Definition->PelletCount;
+	PelletSpreadDegrees = Definition->PelletSpreadDegrees;
+	HitscanDamage = Definition->HitscanDamage;
+	MuzzleOffset = Definition->MuzzleOffset;
+}
+
+void UTP_WeaponComponent::SetDamage(float NewDamage)
+{
+	Damage = NewDamage;
+	if (DamageSpec.IsValid())
+	{
+		DamageSpec.Data->SetSetByCallerMagnitude(HeraTags::Tag_Damage, Damage);
+	}
+}
+
+void UTP_WeaponComponent::BuildDamageSpec()
+{
+	if (!DamageEffectClass || !Character || !Character->HasAuthority())
+	{
+		return;
+	}
+
+	const auto ASC = Character->GetAbilitySystemComponent();
+	if (!ASC || !ASC->AbilityActorInfo.IsValid())
+	{
+		return;
+	}
+
+	auto EffectContextHandle = ASC->MakeEffectContext();
+	EffectContextHandle.AddSourceObject(this);
+
+	DamageSpec = ASC->MakeOutgoingSpec(DamageEffectClass, 1, EffectContextHandle);
+	if (DamageSpec.IsValid())
+	{
+		DamageSpec.Data->SetSetByCallerMagnitude(HeraTags::Tag_Damage, Damage);
 	}
 }
 
 void UTP_WeaponComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
+	StopFiring();
+
 	if (Character == nullptr)
 	{
 		return;
@@ -0,0 +1,12 @@
+// Copyright Final Fall Games. All Rights Reserved.
+
+#include "core/data/weapon_definition.h"
+
+const FPrimaryAssetType UWeaponDefinition::kPrimaryAssetType(TEXT("WeaponDefinition"));
+const FName UWeaponDefinition::kGameplayBundle(TEXT("Gameplay"));
+const FName UWeaponDefinition::kClientBundle(TEXT("Client"));
+
+FPrimaryAssetId UWeaponDefinition::GetPrimaryAssetId() const
+{
+	return FPrimaryAssetId(kPrimaryAssetType, GetFName());
+}
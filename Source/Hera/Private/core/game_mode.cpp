@@ -4,16 +4,71 @@
 #include "core/actors/base_character_actor.h"
 #include "core/base_player_controller.h"
 
-#include "UObject/ConstructorHelpers.h"
+#include "Engine/AssetManager.h"
 
 AHeraGameMode::AHeraGameMode()
 	: Super()
 {
-	// set default pawn class to our Blueprinted character
-	static ConstructorHelpers::FClassFinder<APawn> PlayerPawnClassFinder(
-		TEXT("/Game/FirstPerson/Blueprints/BP_FirstPersonCharacter")
+	// set default pawn class to our Blueprinted character, loaded in InitGame
+	DefaultPawnSoftClass = TSoftClassPtr<APawn>(
+		FSoftClassPath(TEXT("/Game/FirstPerson/Blueprints/BP_FirstPersonCharacter.BP_FirstPersonCharacter_C"))
 	);
-	DefaultPawnClass = PlayerPawnClassFinder.Class;
+	DefaultPawnClass = ACharacterBase::StaticClass();
 
 	PlayerControllerClass = APlayerControllerBase::StaticClass();
 }
+
+void AHeraGameMode::InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage)
+{
+	Super::InitGame(MapName, Options, ErrorMessage);
+
+	// A Blueprint game mode that picked its own DefaultPawnClass keeps it
+	if (DefaultPawnSoftClass.IsNull() || DefaultPawnClass != ACharacterBase::StaticClass())
+	{
+		return;
+	}
+
+	if (DefaultPawnSoftClass.IsPending())
+	{
+		DefaultPawnClassHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+			DefaultPawnSoftClass.ToSoftObjectPath(),
+			FStreamableDelegate::CreateUObject(this, &AHeraGameMode::OnDefaultPawnClassLoaded)
+		);
+	}
+	else
+	{
+		OnDefaultPawnClassLoaded();
+	}
+}
+
+UClass* AHeraGameMode::GetDefaultPawnClassForController_Implementation(AController* InController)
+{
+	if (DefaultPawnClassHandle.IsValid() && DefaultPawnClassHandle->IsLoadingInProgress())
+	{
+		DefaultPawnClassHandle->WaitUntilComplete();
+		OnDefaultPawnClassLoaded();
+	}
+
+	return Super::GetDefaultPawnClassForController_Implementation(InController);
+}
+
+void AHeraGameMode::OnDefaultPawnClassLoaded()
+{
+	if (const auto PawnClass = DefaultPawnSoftClass.Get())
+	{
+		// Only replace the native placeholder the constructor set
+		if (DefaultPawnClass == ACharacterBase::StaticClass())
+		{
+			DefaultPawnClass = PawnClass;
+		}
+		return;
+	}
+
+	UE_LOG(
+		LogTemp, 
+		Error, 
+		TEXT("%s() Failed to load DefaultPawnSoftClass %s. If it was moved please update the reference."),
+		*FString(__FUNCTION__),
+		*DefaultPawnSoftClass.ToString()
+	);
+}
@@ -4,6 +4,9 @@
 #include "core/gas/life_attribute_set.h"
 #include "core/gas/base_asc.h"
 #include "core/gas/tags.h"
+#include "core/hera_stats.h"
+
+DECLARE_CYCLE_STAT(TEXT("DamageExecution"), STAT_Hera_DamageExecution, STATGROUP_Hera);
 
 // Declare the attributes to capture and define how we want to capture them from the Source and Target.
 struct FDamageCapture
@@ -56,11 +59,20 @@ UDamageExecution::UDamageExecution()
 	RelevantAttributesToCapture.Add(GetDamageCapture().OverArmorDef);
 }
 
+float UDamageExecution::MitigateDamage(float UnmitigatedDamage, float Armor, float OverArmor)
+{
+	// All Armor in the Health Pool will mitigate 50% of the incoming damage
+	const float DamageMitigated = FMath::Min<float>(UnmitigatedDamage, (Armor + OverArmor));
+	return UnmitigatedDamage - DamageMitigated + (DamageMitigated * 0.5f);
+}
+
 void UDamageExecution::Execute_Implementation(
 	const FGameplayEffectCustomExecutionParameters& ExecutionParams, 
 	OUT FGameplayEffectCustomExecutionOutput& OutExecutionOutput
 ) const
 {
+	HERA_SCOPE_CYCLE_COUNTER(DamageExecution);
+
 	auto TargetASC = ExecutionParams.GetTargetAbilitySystemComponent();
 	auto SourceASC = ExecutionParams.GetSourceAbilitySystemComponent();
 	auto TargetAvatar = TargetASC ? TargetASC->GetAvatarActor() : nullptr;
@@ -94,6 +106,12 @@ void UDamageExecution::Execute_Implementation(
 	);
 	OverArmor = FMath::Max<float>(OverArmor, 0.0f);
 
+	// Earlier hits this frame may not be committed yet, mitigate against the armor they leave
+	if (const auto LifeAttributes = TargetASC ? TargetASC->GetSet<ULifeAttributeSet>() : nullptr)
+	{
+		LifeAttributes->RemovePendingArmor(Armor, OverArmor);
+	}
+
 	// Grabs the value from the attribute set, goes through Effects and see if anything will change 
 	// the Damage attribute, and adds it to the Damage float.
 	// Value set on the damage GE as a CalculationModifier under the ExecutionCalculation.
@@ -124,9 +142,7 @@ void UDamageExecution::Execute_Implementation(
 	// 	MutableSpec->DynamicAssetTags.AddTag(FGameplayTag::RequestGameplayTag(FName("Effect.Damage.HeadShot")));
 	// }
 	
-	// All Armor in the Health Pool will mitigate 50% of the incoming damage
-	const float DamageMitigated = FMath::Min<float>(UnmitigatedDamage, (Armor + OverArmor));
-	const float FinalDamage = UnmitigatedDamage - DamageMitigated + (DamageMitigated * 0.5f);
+	const float FinalDamage = MitigateDamage(UnmitigatedDamage, Armor, OverArmor);
 
 	if (FinalDamage > 0.f)
 	{
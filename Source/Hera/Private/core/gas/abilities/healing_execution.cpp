@@ -4,6 +4,9 @@
 #include "core/gas/life_attribute_set.h"
 #include "core/gas/base_asc.h"
 #include "core/gas/tags.h"
+#include "core/hera_stats.h"
+
+DECLARE_CYCLE_STAT(TEXT("HealingExecution"), STAT_Hera_HealingExecution, STATGROUP_Hera);
 
 // Declare the attributes to capture and define how we want to capture them from the Source and Target.
 struct FHealingCapture
@@ -34,6 +37,8 @@ void UHealingExecution::Execute_Implementation(
 	OUT FGameplayEffectCustomExecutionOutput& OutExecutionOutput
 ) const
 {
+	HERA_SCOPE_CYCLE_COUNTER(HealingExecution);
+
 	auto TargetASC = ExecutionParams.GetTargetAbilitySystemComponent();
 	auto SourceASC = ExecutionParams.GetSourceAbilitySystemComponent();
 	auto TargetAvatar = TargetASC ? TargetASC->GetAvatarActor() : nullptr;
@@ -2,6 +2,16 @@
 
 
 #include "core/gas/base_asc.h"
+#include "core/gas/effects/bounty_effect.h"
+#include "core/gas/abilities/damage_execution.h"
+#include "core/gas/life_attribute_set.h"
+#include "core/subsystems/combat_log_subsystem.h"
+#include "core/hera_stats.h"
+
+#include "AbilitySystemGlobals.h"
+#include "TimerManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("ApplyDirectDamage"), STAT_Hera_ApplyDirectDamage, STATGROUP_Hera);
 
 void UAbilitySystemComponentBase::OnReceivedDamage(
    UAbilitySystemComponentBase* SourceASC, 
@@ -9,6 +19,11 @@ void UAbilitySystemComponentBase::OnReceivedDamage(
    float FinalDamage
 )
 {
+	if (auto CombatLog = UCombatLogSubsystem::Get(this))
+	{
+		CombatLog->LogDamage(SourceASC, this, UnmitigatedDamage, FinalDamage);
+	}
+
 	DamageReceivedDelegate.Broadcast(SourceASC, UnmitigatedDamage, FinalDamage);
 }
 
@@ -18,5 +33,99 @@ void UAbilitySystemComponentBase::OnReceivedHealing(
    float FinalHealing
 )
 {
+	if (auto CombatLog = UCombatLogSubsystem::Get(this))
+	{
+		CombatLog->LogHealing(SourceASC, this, UnmitigatedHealing, FinalHealing);
+	}
+
 	HealingReceivedDelegate.Broadcast(SourceASC, UnmitigatedHealing, FinalHealing);
+}
+
+float UAbilitySystemComponentBase::ApplyDirectDamage(UAbilitySystemComponentBase* SourceASC, float UnmitigatedDamage)
+{
+	HERA_SCOPE_CYCLE_COUNTER(ApplyDirectDamage);
+
+	if (!IsOwnerActorAuthoritative() || !(UnmitigatedDamage > 0.0f))
+	{
+		return 0.0f;
+	}
+
+	auto LifeAttributes = const_cast<ULifeAttributeSet*>(GetSet<ULifeAttributeSet>());
+	if (!LifeAttributes)
+	{
+		return 0.0f;
+	}
+
+	float Armor = FMath::Max<float>(LifeAttributes->GetArmor(), 0.0f);
+	float OverArmor = FMath::Max<float>(LifeAttributes->GetOverArmor(), 0.0f);
+	LifeAttributes->RemovePendingArmor(Armor, OverArmor);
+	const float FinalDamage = UDamageExecution::MitigateDamage(UnmitigatedDamage, Armor, OverArmor);
+
+	if (FinalDamage > 0.0f)
+	{
+		OnReceivedDamage(SourceASC, UnmitigatedDamage, FinalDamage);
+		LifeAttributes->ReceiveDirectDamage(FinalDamage, SourceASC);
+	}
+
+	return FinalDamage;
+}
+
+void UAbilitySystemComponentBase::ApplyHitDamage(
+	AActor* TargetActor, 
+	AActor* SourceActor, 
+	const FGameplayEffectSpecHandle& EffectSpecHandle, 
+	float DirectDamage
+)
+{
+	const auto TargetASC = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(TargetActor);
+	if (!TargetASC || !TargetASC->IsOwnerActorAuthoritative())
+	{
+		return;
+	}
+
+	if (EffectSpecHandle.IsValid())
+	{
+		TargetASC->ApplyGameplayEffectSpecToSelf(*EffectSpecHandle.Data.Get());
+	}
+	else if (DirectDamage > 0.0f)
+	{
+		if (const auto TargetHeroASC = Cast<UAbilitySystemComponentBase>(TargetASC))
+		{
+			const auto SourceASC = Cast<UAbilitySystemComponentBase>(
+				UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(SourceActor)
+			);
+			TargetHeroASC->ApplyDirectDamage(SourceASC, DirectDamage);
+		}
+	}
+}
+
+void UAbilitySystemComponentBase::QueueKillReward(float RewardXP)
+{
+	PendingRewardXP += RewardXP;
+	PendingKillCount++;
+
+	const auto World = GetWorld();
+	if (!World)
+	{
+		FlushKillRewards();
+	}
+	else if (PendingKillCount == 1)
+	{
+		// First kill of the frame schedules the reward
+		World->GetTimerManager().SetTimerForNextTick(this, &UAbilitySystemComponentBase::FlushKillRewards);
+	}
+}
+
+void UAbilitySystemComponentBase::FlushKillRewards()
+{
+	if (PendingKillCount == 0)
+	{
+		return;
+	}
+
+	const float RewardXP = PendingRewardXP;
+	PendingRewardXP = 0.0f;
+	PendingKillCount = 0;
+
+	UBountyEffect::ApplyBounty(this, RewardXP);
 }
\ No newline at end of file
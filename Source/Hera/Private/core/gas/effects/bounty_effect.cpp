@@ -0,0 +1,46 @@
+// Copyright Final Fall Games. All Rights Reserved.
+
+#include "core/gas/effects/bounty_effect.h"
+#include "core/gas/life_attribute_set.h"
+#include "core/gas/tags.h"
+
+#include "AbilitySystemComponent.h"
+
+UBountyEffect::UBountyEffect()
+{
+	DurationPolicy = EGameplayEffectDurationType::Instant;
+
+	// XP Reward for the Source
+	FSetByCallerFloat XPMagnitude;
+	XPMagnitude.DataTag = HeraTags::Tag_BountyXP;
+
+	FGameplayModifierInfo InfoXP;
+	InfoXP.ModifierMagnitude = FGameplayEffectModifierMagnitude(XPMagnitude);
+	InfoXP.ModifierOp = EGameplayModOp::Additive;
+	InfoXP.Attribute = ULifeAttributeSet::GetXPAttribute();
+	Modifiers.Add(InfoXP);
+
+	// Potential gold reward for the Source
+	// FSetByCallerFloat GoldMagnitude;
+	// GoldMagnitude.DataTag = HeraTags::Tag_BountyGold;
+	//
+	// FGameplayModifierInfo InfoGold;
+	// InfoGold.ModifierMagnitude = FGameplayEffectModifierMagnitude(GoldMagnitude);
+	// InfoGold.ModifierOp = EGameplayModOp::Additive;
+	// InfoGold.Attribute = ULifeAttributeSet::GetGoldAttribute();
+	// Modifiers.Add(InfoGold);
+}
+
+void UBountyEffect::ApplyBounty(UAbilitySystemComponent* ASC, const float RewardXP)
+{
+	if (!IsValid(ASC))
+	{
+		return;
+	}
+
+	// The spec lives on the stack and points at the CDO, so nothing here creates a UObject
+	FGameplayEffectSpec Spec(GetDefault<UBountyEffect>(), ASC->MakeEffectContext(), 1.0f);
+	Spec.SetSetByCallerMagnitude(HeraTags::Tag_BountyXP, RewardXP);
+
+	ASC->ApplyGameplayEffectSpecToSelf(Spec);
+}
@@ -2,11 +2,205 @@
 
 
 #include "core/gas/life_attribute_set.h"
+#include "core/gas/life_pool_kernel.h"
+#include "core/gas/base_asc.h"
+#include "core/gas/effects/bounty_effect.h"
 #include "core/actors/base_character_actor.h"
+#include "core/subsystems/combat_log_subsystem.h"
+#include "core/hera_stats.h"
 
 #include "GameplayEffect.h"
 #include "GameplayEffectExtension.h"
 #include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+#include "TimerManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("PostGameplayEffectExecute"), STAT_Hera_PostGameplayEffectExecute, STATGROUP_Hera);
+DECLARE_CYCLE_STAT(TEXT("HandleDamage"), STAT_Hera_HandleDamage, STATGROUP_Hera);
+DECLARE_CYCLE_STAT(TEXT("HandleHealing"), STAT_Hera_HandleHealing, STATGROUP_Hera);
+DECLARE_CYCLE_STAT(TEXT("HandleKillReward"), STAT_Hera_HandleKillReward, STATGROUP_Hera);
+DECLARE_CYCLE_STAT(TEXT("FlushPendingDamage"), STAT_Hera_FlushPendingDamage, STATGROUP_Hera);
+
+static TAutoConsoleVariable<int32> CVarCoalesceDamage(
+	TEXT("Hera.Damage.Coalesce"),
+	1,
+	TEXT("Sum the damage a target receives during a frame and commit it as one change to the life pool.\n")
+	TEXT("0: Commit every hit as it's executed\n")
+	TEXT("1: Commit once per frame (default)"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<int32> CVarPackedLifePool(
+	TEXT("Hera.Net.PackedLifePool"),
+	0,
+	TEXT("Replicate the health pool to simulated proxies as one quantized FLifePoolRepData instead of eight ")
+	TEXT("FGameplayAttributeData properties. The owner always receives the individual attributes.\n")
+	TEXT("Must match on the server and clients. Set it in the [SystemSettings] section of the ini or on the command line."),
+	ECVF_ReadOnly
+);
+
+//---------------------------------------------------------------------------------------------------------------------
+/// MARK: - FLifePoolRepData
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace
+{
+	/// Values are replicated in tenths of a point
+	constexpr float kLifePoolQuantizeScale = 10.0f;
+
+	/// Fields that are skipped when they equal the max in the matching slot of kLifePoolMaxFields.
+	constexpr FLifePoolRepData::EField kLifePoolFullFields[] = { 
+		FLifePoolRepData::Health, 
+		FLifePoolRepData::Shields, 
+		FLifePoolRepData::Armor 
+	};
+	constexpr FLifePoolRepData::EField kLifePoolMaxFields[] = { 
+		FLifePoolRepData::MaxHealth, 
+		FLifePoolRepData::MaxShields, 
+		FLifePoolRepData::MaxArmor 
+	};
+	constexpr int32 kLifePoolFullFieldCount = UE_ARRAY_COUNT(kLifePoolFullFields);
+}
+
+float FLifePoolRepData::GetValue(EField Field) const
+{
+	return Values[Field] / kLifePoolQuantizeScale;
+}
+
+bool FLifePoolRepData::SetValue(EField Field, float NewValue)
+{
+	// Round down so floor(Health) on the client, which decides IsAlive, matches the server
+	const uint32 Quantized = static_cast<uint32>(FMath::Max<int32>(
+		FMath::FloorToInt(NewValue * kLifePoolQuantizeScale + KINDA_SMALL_NUMBER), 
+		0
+	));
+
+	if (Values[Field] == Quantized)
+	{
+		return false;
+	}
+
+	Values[Field] = Quantized;
+	return true;
+}
+
+bool FLifePoolRepData::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	uint8 ZeroMask = 0;
+	uint8 FullMask = 0;
+
+	if (Ar.IsSaving())
+	{
+		for (int32 Field = 0; Field < FieldCount; ++Field)
+		{
+			if (Values[Field] == 0)
+			{
+				ZeroMask |= 1 << Field;
+			}
+		}
+
+		for (int32 Index = 0; Index < kLifePoolFullFieldCount; ++Index)
+		{
+			const uint32 Value = Values[kLifePoolFullFields[Index]];
+			if (Value != 0 && Value == Values[kLifePoolMaxFields[Index]])
+			{
+				FullMask |= 1 << Index;
+			}
+		}
+	}
+
+	Ar << ZeroMask;
+	Ar.SerializeBits(&FullMask, kLifePoolFullFieldCount);
+
+	for (int32 Field = 0; Field < FieldCount; ++Field)
+	{
+		if (ZeroMask & (1 << Field))
+		{
+			Values[Field] = 0;
+			continue;
+		}
+
+		bool bIsFull = false;
+		for (int32 Index = 0; Index < kLifePoolFullFieldCount; ++Index)
+		{
+			bIsFull |= kLifePoolFullFields[Index] == Field && (FullMask & (1 << Index));
+		}
+
+		if (!bIsFull)
+		{
+			Ar.SerializeIntPacked(Values[Field]);
+		}
+	}
+
+	// Full pools take their max, which has been read by now
+	if (Ar.IsLoading())
+	{
+		for (int32 Index = 0; Index < kLifePoolFullFieldCount; ++Index)
+		{
+			if (FullMask & (1 << Index))
+			{
+				Values[kLifePoolFullFields[Index]] = Values[kLifePoolMaxFields[Index]];
+			}
+		}
+	}
+
+	bOutSuccess = !Ar.IsError();
+	return true;
+}
+
+bool FLifePoolRepData::operator==(const FLifePoolRepData& Other) const
+{
+	return FMemory::Memcmp(Values, Other.Values, sizeof(Values)) == 0;
+}
+
+/// Returns the packed field for one of the health pool attributes, FieldCount for anything else.
+static FLifePoolRepData::EField GetPackedLifePoolField(const FGameplayAttribute& Attribute)
+{
+	if (Attribute == ULifeAttributeSet::GetMaxHealthAttribute())  return FLifePoolRepData::MaxHealth;
+	if (Attribute == ULifeAttributeSet::GetHealthAttribute())     return FLifePoolRepData::Health;
+	if (Attribute == ULifeAttributeSet::GetMaxShieldsAttribute()) return FLifePoolRepData::MaxShields;
+	if (Attribute == ULifeAttributeSet::GetShieldsAttribute())    return FLifePoolRepData::Shields;
+	if (Attribute == ULifeAttributeSet::GetMaxArmorAttribute())   return FLifePoolRepData::MaxArmor;
+	if (Attribute == ULifeAttributeSet::GetArmorAttribute())      return FLifePoolRepData::Armor;
+	if (Attribute == ULifeAttributeSet::GetOverHealthAttribute()) return FLifePoolRepData::OverHealth;
+	if (Attribute == ULifeAttributeSet::GetOverArmorAttribute())  return FLifePoolRepData::OverArmor;
+
+	return FLifePoolRepData::FieldCount;
+}
+
+/// The controller of the Source ASC's avatar, falling back to the pawn's controller when it isn't a player.
+static AController* FindSourceController(UAbilitySystemComponent* SourceASC)
+{
+	if (!SourceASC || !SourceASC->AbilityActorInfo.IsValid())
+	{
+		return nullptr;
+	}
+
+	AController* SourceController = SourceASC->AbilityActorInfo->PlayerController.Get();
+	if (SourceController == nullptr)
+	{
+		if (auto Pawn = Cast<APawn>(SourceASC->AbilityActorInfo->AvatarActor.Get()))
+		{
+			SourceController = Pawn->GetController();
+		}
+	}
+
+	return SourceController;
+}
+
+/// Push model: flag a replicated attribute as written. Meta attributes like Damage aren't replicated and are skipped.
+static void MarkAttributeDirty(const ULifeAttributeSet* AttributeSet, const FGameplayAttribute& Attribute)
+{
+	const auto Property = Attribute.GetUProperty();
+	if (Property && Property->HasAnyPropertyFlags(CPF_Net))
+	{
+		MARK_PROPERTY_DIRTY(AttributeSet, Property);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// MARK: - ULifeAttributeSet
+//---------------------------------------------------------------------------------------------------------------------
 
 ULifeAttributeSet::ULifeAttributeSet()
 {
@@ -15,6 +209,8 @@ ULifeAttributeSet::ULifeAttributeSet()
 
 void ULifeAttributeSet::HandleDamage(const float DamageReceived /*, SourceCharacterTags*/)
 {
+	HERA_SCOPE_CYCLE_COUNTER(HandleDamage);
+
 	/// TODO: Check for GameplayTags like:
 	//       - Immortal       : Can't fall below 1hp
 	//       - Invulnerable   : Doesn't take any damage
@@ -25,124 +221,212 @@ void ULifeAttributeSet::HandleDamage(const float DamageReceived /*, SourceCharac
 		return;
 	}
 
-	// Starting values
-	float RemainingDamage     = DamageReceived;
-	const float OldOverArmor  = GetOverArmor();
-	const float OldOverHealth = GetOverHealth();
-	const float OldArmor      = GetArmor();
-	const float OldShields    = GetShields();
-	const float OldHealth     = GetHealth();
+	const auto OldPool = GetLifePool();
+	auto NewPool = OldPool;
+	HeraLifePool::ApplyDamage(NewPool, DamageReceived);
+	CommitLifePool(OldPool, NewPool);
+}
 
-	auto DamagedValue = [&RemainingDamage](const float& OldValue) -> float
-	{
-		const float AttributeDamage = FMath::Min<float>(OldValue, RemainingDamage);
-		const float NewValue = OldValue - AttributeDamage;
-		RemainingDamage -= AttributeDamage;
-		return FMath::Clamp<float>(NewValue, 0.0f, OldValue);
-	};
+void ULifeAttributeSet::HandleHealing(const float HealingReceived)
+{
+	HERA_SCOPE_CYCLE_COUNTER(HandleHealing);
 
-	// OverArmor
-	if (OldOverArmor > 0.0f)
+	/// TODO: Check for GameplayTags like:
+	//       - Cursed : Can't receive healing
+
+	if (!(HealingReceived > 0)) {
+		return;
+	}
+
+	const auto OldPool = GetLifePool();
+	auto NewPool = OldPool;
+	HeraLifePool::ApplyHealing(NewPool, HealingReceived);
+	CommitLifePool(OldPool, NewPool);
+}
+
+FLifePoolValues ULifeAttributeSet::GetLifePool() const
+{
+	FLifePoolValues Pool;
+	Pool.OverArmor  = GetOverArmor();
+	Pool.OverHealth = GetOverHealth();
+	Pool.Armor      = GetArmor();
+	Pool.Shields    = GetShields();
+	Pool.Health     = GetHealth();
+	Pool.MaxArmor   = GetMaxArmor();
+	Pool.MaxShields = GetMaxShields();
+	Pool.MaxHealth  = GetMaxHealth();
+	return Pool;
+}
+
+void ULifeAttributeSet::CommitLifePool(const FLifePoolValues& OldPool, const FLifePoolValues& NewPool)
+{
+	// Only touch the layers the cascade actually changed so untouched attributes don't fire change callbacks
+	if (NewPool.OverArmor != OldPool.OverArmor)
 	{
-		SetOverArmor(DamagedValue(OldOverArmor));
+		SetOverArmor(NewPool.OverArmor);
 	}
-	
-	// OverHealth
-	if (OldOverHealth > 0 && RemainingDamage > 0)
+
+	if (NewPool.OverHealth != OldPool.OverHealth)
 	{
-		SetOverHealth(DamagedValue(OldOverHealth));
+		SetOverHealth(NewPool.OverHealth);
 	}
 
-	// Armor
-	if (OldArmor > 0 && RemainingDamage > 0)
+	if (NewPool.Armor != OldPool.Armor)
 	{
-		SetArmor(DamagedValue(OldArmor));
+		SetArmor(NewPool.Armor);
 	}
 
-	// Shields
-	if (OldShields > 0 && RemainingDamage > 0)
+	if (NewPool.Shields != OldPool.Shields)
 	{
-		SetShields(DamagedValue(OldShields));
+		SetShields(NewPool.Shields);
 	}
 
-	// Health
-	if (OldHealth > 0 && RemainingDamage > 0)
+	if (NewPool.Health != OldPool.Health)
 	{
-		SetHealth(DamagedValue(OldHealth));
+		SetHealth(NewPool.Health);
 	}
 }
 
-void ULifeAttributeSet::HandleHealing(const float HealingReceived)
+void ULifeAttributeSet::HandleKillReward(UAbilitySystemComponent* SourceASC)
 {
-	/// TODO: Check for GameplayTags like:
-	//       - Cursed : Can't receive healing
+	HERA_SCOPE_CYCLE_COUNTER(HandleKillReward);
 
-	if (!(HealingReceived > 0)) {
-		return;
+	// Kills landing in the same frame are granted together by the killer's ASC
+	if (auto SourceHeroASC = Cast<UAbilitySystemComponentBase>(SourceASC))
+	{
+		SourceHeroASC->QueueKillReward(GetRewardXP());
+	}
+	else
+	{
+		UBountyEffect::ApplyBounty(SourceASC, GetRewardXP());
 	}
+}
 
-	// Starting values
-	float RemainingHealing = HealingReceived;
-	const float OldHealth  = GetHealth();
-	const float OldShields = GetShields();
-	const float OldArmor   = GetArmor();
-	const float HealthMax  = GetMaxHealth();
-	const float ShieldsMax = GetMaxShields();
-	const float ArmorMax   = GetMaxArmor();
-	
-	auto HealedValue = [&RemainingHealing](const float& OldValue, const float& MaxValue) -> float
+void ULifeAttributeSet::ReceiveDirectDamage(const float FinalDamage, UAbilitySystemComponent* SourceASC)
+{
+	if (FinalDamage > 0.0f)
 	{
-		const float AttributeHealing = FMath::Min<float>(MaxValue - OldValue, RemainingHealing);
-		const float NewValue = OldValue + AttributeHealing;
-		RemainingHealing -= AttributeHealing;
-		return FMath::Clamp<float>(NewValue, OldValue, MaxValue);
-	};
+		QueueDamage(FinalDamage, SourceASC, FindSourceController(SourceASC));
+	}
+}
 
-	// Health
-	if (OldHealth < HealthMax)
+void ULifeAttributeSet::RemovePendingArmor(float& InOutArmor, float& InOutOverArmor) const
+{
+	if (PendingDamage.Num() == 0)
 	{
-		SetHealth(HealedValue(OldHealth, HealthMax));
+		return;
 	}
 
-	// Shields
-	if (OldShields < ShieldsMax && RemainingHealing > 0)
+	// The cascade is a greedy fill, so the frame's hits can be applied as one sum
+	float PendingTotal = 0.0f;
+	for (const auto& Hit : PendingDamage)
 	{
-		SetShields(HealedValue(OldShields, ShieldsMax));
+		PendingTotal += Hit.Damage;
 	}
 
-	// Armor
-	if (OldArmor < ArmorMax && RemainingHealing > 0)
+	const auto Pool = GetLifePool();
+	auto PendingPool = Pool;
+	HeraLifePool::ApplyDamage(PendingPool, PendingTotal);
+
+	InOutArmor = FMath::Max<float>(InOutArmor - (Pool.Armor - PendingPool.Armor), 0.0f);
+	InOutOverArmor = FMath::Max<float>(InOutOverArmor - (Pool.OverArmor - PendingPool.OverArmor), 0.0f);
+}
+
+void ULifeAttributeSet::QueueDamage(
+	const float DamageReceived, 
+	UAbilitySystemComponent* SourceASC, 
+	AController* SourceController
+)
+{
+	INC_DWORD_STAT(STAT_Hera_HitsPerFrame);
+	CSV_CUSTOM_STAT(Hera, HitsPerFrame, 1, ECsvCustomStatOp::Accumulate);
+
+	// One entry per hit, so the kill goes to whoever's hit actually emptied the pool
+	FPendingDamage& Entry = PendingDamage.AddDefaulted_GetRef();
+	Entry.SourceASC = SourceASC;
+	Entry.SourceController = SourceController;
+	Entry.Damage = DamageReceived;
+
+	const auto World = GetWorld();
+	if (CVarCoalesceDamage.GetValueOnGameThread() <= 0 || !World)
 	{
-		SetArmor(HealedValue(OldArmor, ArmorMax));
+		FlushPendingDamage();
+	}
+	else if (PendingDamage.Num() == 1)
+	{
+		// First hit of the frame schedules the commit
+		World->GetTimerManager().SetTimerForNextTick(this, &ULifeAttributeSet::FlushPendingDamage);
 	}
 }
 
-void ULifeAttributeSet::HandleKillReward(UAbilitySystemComponent* SourceASC)
+void ULifeAttributeSet::FlushPendingDamage()
 {
-	// Create a dynamic instant Gameplay Effect to give the bounties
-	auto BountyEffect = NewObject<UGameplayEffect>(GetTransientPackage(), FName(TEXT("Bounty")));
-	BountyEffect->DurationPolicy = EGameplayEffectDurationType::Instant;
+	if (PendingDamage.Num() == 0)
+	{
+		return;
+	}
 
-	int32 BountyModInfoCount = BountyEffect->Modifiers.Num();
+	HERA_SCOPE_CYCLE_COUNTER(FlushPendingDamage);
 
-	// This should add the number of Attributes being modified. (XP, gold, etc)
-	const int NewModsCount = 1; // XP
-	BountyEffect->Modifiers.SetNum(BountyModInfoCount + NewModsCount);
+	// Take the pending hits first so anything reacting to the commit starts a new frame of damage
+	const auto Hits = MoveTemp(PendingDamage);
+	PendingDamage.Reset();
+
+	// Get the Target, which should be our owner
+	AController* TargetController = nullptr;
+	ACharacterBase* TargetCharacter = nullptr;
+	const auto ASC = GetOwningAbilitySystemComponent();
+	if (ASC && ASC->AbilityActorInfo.IsValid() && ASC->AbilityActorInfo->AvatarActor.IsValid())
+	{
+		TargetController = ASC->AbilityActorInfo->PlayerController.Get();
+		TargetCharacter = Cast<ACharacterBase>(ASC->AbilityActorInfo->AvatarActor.Get());
+	}
 
-	// XP Reward for the Source
-	FGameplayModifierInfo& InfoXP = BountyEffect->Modifiers[BountyModInfoCount];
-	InfoXP.ModifierMagnitude = FScalableFloat(GetRewardXP());
-	InfoXP.ModifierOp = EGameplayModOp::Additive;
-	InfoXP.Attribute = ULifeAttributeSet::GetXPAttribute();
+	// This prevents damage being added to dead things and replaying death animations
+	const bool WasAlive = TargetCharacter ? TargetCharacter->IsAlive() : true;
 
-	// Potential gold reward for the Source
-	// FGameplayModifierInfo& InfoGold = BountyEffect->Modifiers[BountyModInfoCount + 1];
-	// InfoGold.ModifierMagnitude = FScalableFloat(GetGoldBounty());
-	// InfoGold.ModifierOp = EGameplayModOp::Additive;
-	// InfoGold.Attribute = ULifeAttributeSet::GetGoldAttribute();
+	// Walk the hits in order on a local copy of the pool to find out which source landed the killing blow,
+	// then commit the whole frame with one set of attribute changes.
+	auto Pool = GetLifePool();
+	float TotalDamage = 0.0f;
+	const FPendingDamage* KillingHit = nullptr;
+	for (const auto& Hit : Hits)
+	{
+		const bool PoolWasAlive = HeraLifePool::IsAlive(Pool);
+		HeraLifePool::ApplyDamage(Pool, Hit.Damage);
+		TotalDamage += Hit.Damage;
 
-	// Apply the reward to the killer
-	SourceASC->ApplyGameplayEffectToSelf(BountyEffect, 1.0f, SourceASC->MakeEffectContext());
+		if (!KillingHit && PoolWasAlive && !HeraLifePool::IsAlive(Pool))
+		{
+			KillingHit = &Hit;
+		}
+	}
+	HandleDamage(TotalDamage);
+
+	// Post-damage effects
+	if (TargetCharacter && WasAlive)
+	{
+		/// TODO: Feedback to SourceController
+
+		// Check if TargetCharacter was killed
+		if (KillingHit && !TargetCharacter->IsAlive())
+		{
+			INC_DWORD_STAT(STAT_Hera_KillsPerFrame);
+			CSV_CUSTOM_STAT(Hera, KillsPerFrame, 1, ECsvCustomStatOp::Accumulate);
+
+			const auto KillerASC = KillingHit->SourceASC.Get();
+			if (auto CombatLog = UCombatLogSubsystem::Get(this))
+			{
+				CombatLog->LogKill(KillerASC, ASC);
+			}
+
+			// Don't give bounty to self
+			if (KillerASC && KillingHit->SourceController.Get() != TargetController)
+			{
+				HandleKillReward(KillerASC);
+			}
+		}
+	}
 }
 
 //---------------------------------------------------------------------------------------------------------------------
@@ -180,8 +464,39 @@ void ULifeAttributeSet::PreAttributeChange(const FGameplayAttribute& Attribute,
 	}
 }
 
+void ULifeAttributeSet::PostAttributeChange(const FGameplayAttribute& Attribute, float OldValue, float NewValue)
+{
+	Super::PostAttributeChange(Attribute, OldValue, NewValue);
+
+	// Every write goes through here: the ATTRIBUTE_ACCESSORS setters, HandleDamage/HandleHealing through
+	// CommitLifePool, and the aggregators of active GameplayEffects.
+	MarkAttributeDirty(this, Attribute);
+
+	// Keep the packed health pool in sync on the server. Simulated proxies don't receive the GameplayEffects
+	// so they get the CurrentValue, same as what the UI shows on the server.
+	const auto OwningActor = GetOwningActor();
+	if (CVarPackedLifePool.GetValueOnGameThread() > 0 && OwningActor && OwningActor->HasAuthority())
+	{
+		const auto Field = GetPackedLifePoolField(Attribute);
+		if (Field != FLifePoolRepData::FieldCount && PackedLifePool.SetValue(Field, NewValue))
+		{
+			MARK_PROPERTY_DIRTY_FROM_NAME(ULifeAttributeSet, PackedLifePool, this);
+		}
+	}
+}
+
+void ULifeAttributeSet::PostAttributeBaseChange(const FGameplayAttribute& Attribute, float OldValue, float NewValue) const
+{
+	Super::PostAttributeBaseChange(Attribute, OldValue, NewValue);
+
+	// The BaseValue replicates too, and it can change without the CurrentValue changing when a mod overrides it
+	MarkAttributeDirty(this, Attribute);
+}
+
 void ULifeAttributeSet::PostGameplayEffectExecute(const FGameplayEffectModCallbackData& Data)
 {
+	HERA_SCOPE_CYCLE_COUNTER(PostGameplayEffectExecute);
+
 	// The ExecutionCalculation in the ExecutionDefinition is called in Execute,
 	// then we come here.
 
@@ -211,14 +526,7 @@ void ULifeAttributeSet::PostGameplayEffectExecute(const FGameplayEffectModCallba
 	if (SourceASC && SourceASC->AbilityActorInfo.IsValid() && SourceASC->AbilityActorInfo->AvatarActor.IsValid())
 	{
 		SourceActor = SourceASC->AbilityActorInfo->AvatarActor.Get();
-		SourceController = SourceASC->AbilityActorInfo->PlayerController.Get();
-		if (SourceController == nullptr && SourceActor != nullptr)
-		{
-			if (auto Pawn = Cast<APawn>(SourceActor))
-			{
-				SourceController = Pawn->GetController();
-			}
-		}
+		SourceController = FindSourceController(SourceASC);
 
 		// Get Source Pawn with their controller
 		if (SourceController)
@@ -250,31 +558,7 @@ void ULifeAttributeSet::PostGameplayEffectExecute(const FGameplayEffectModCallba
 
 		if (DamageReceived > 0.0f)
 		{
-			// This prevents damage being added to dead things and replaying death animations
-			bool WasAlive = true;
-
-			if (TargetCharacter)
-			{
-				WasAlive = TargetCharacter->IsAlive();
-			}
-
-			HandleDamage(DamageReceived);
-
-			// Post-damage effects
-			if (TargetCharacter && WasAlive)
-			{
-				/// TODO: Feedback to SourceController
-			
-				// Check if TargetCharacter was killed
-				if (!TargetCharacter->IsAlive())
-				{
-					// Don't give bounty to self
-					if (SourceController != TargetController)
-					{
-						HandleKillReward(SourceASC);
-					}
-				}
-			}
+			QueueDamage(DamageReceived, SourceASC, SourceController);
 		}
 	}// Damage
 
@@ -283,6 +567,9 @@ void ULifeAttributeSet::PostGameplayEffectExecute(const FGameplayEffectModCallba
 	{
 		const float HealingReceived = GetHealing();
 		SetHealing(0.0f);
+
+		// Keep damage and healing in the order they were executed
+		FlushPendingDamage();
 		HandleHealing(HealingReceived);
 	} // Healing
 
@@ -352,18 +639,71 @@ void ULifeAttributeSet::GetLifetimeReplicatedProps(TArray<FLifetimeProperty> &Ou
 {
    Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-   DOREPLIFETIME_CONDITION_NOTIFY(ULifeAttributeSet, MaxHealth,      COND_None, REPNOTIFY_Always);
-   DOREPLIFETIME_CONDITION_NOTIFY(ULifeAttributeSet, Health,         COND_None, REPNOTIFY_Always);
-   DOREPLIFETIME_CONDITION_NOTIFY(ULifeAttributeSet, MaxShields,     COND_None, REPNOTIFY_Always);
-   DOREPLIFETIME_CONDITION_NOTIFY(ULifeAttributeSet, Shields,        COND_None, REPNOTIFY_Always);
-   DOREPLIFETIME_CONDITION_NOTIFY(ULifeAttributeSet, MaxArmor,       COND_None, REPNOTIFY_Always);
-   DOREPLIFETIME_CONDITION_NOTIFY(ULifeAttributeSet, Armor,          COND_None, REPNOTIFY_Always);
-   DOREPLIFETIME_CONDITION_NOTIFY(ULifeAttributeSet, OverHealth,     COND_None, REPNOTIFY_Always);
-   DOREPLIFETIME_CONDITION_NOTIFY(ULifeAttributeSet, OverArmor,      COND_None, REPNOTIFY_Always);
-   DOREPLIFETIME_CONDITION_NOTIFY(ULifeAttributeSet, MoveSpeed,      COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(ULifeAttributeSet, Level,          COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(ULifeAttributeSet, XP,             COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(ULifeAttributeSet, RewardXP,       COND_None, REPNOTIFY_Always);
+	// With the packed health pool the individual attributes only go to the owner
+	const bool bPackedLifePool = CVarPackedLifePool.GetValueOnAnyThread() > 0;
+	const auto LifePoolCondition = bPackedLifePool ? COND_OwnerOnly : COND_None;
+	const auto PackedCondition = bPackedLifePool ? COND_SkipOwner : COND_Never;
+
+	// Everything is push based. PostAttributeChange and PostAttributeBaseChange mark the properties dirty, so the
+	// server only compares attributes that were actually written this frame.
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	Params.RepNotifyCondition = REPNOTIFY_Always;
+
+	// Health pool
+	Params.Condition = LifePoolCondition;
+	DOREPLIFETIME_WITH_PARAMS_FAST(ULifeAttributeSet, MaxHealth,  Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ULifeAttributeSet, Health,     Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ULifeAttributeSet, MaxShields, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ULifeAttributeSet, Shields,    Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ULifeAttributeSet, MaxArmor,   Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ULifeAttributeSet, Armor,      Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ULifeAttributeSet, OverHealth, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ULifeAttributeSet, OverArmor,  Params);
+
+	// Everyone needs MoveSpeed to simulate movement
+	Params.Condition = COND_None;
+	DOREPLIFETIME_WITH_PARAMS_FAST(ULifeAttributeSet, MoveSpeed, Params);
+
+	// Progression is only shown to the owner
+	Params.Condition = COND_OwnerOnly;
+	DOREPLIFETIME_WITH_PARAMS_FAST(ULifeAttributeSet, Level,    Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ULifeAttributeSet, XP,       Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ULifeAttributeSet, RewardXP, Params);
+
+	Params.Condition = PackedCondition;
+	Params.RepNotifyCondition = REPNOTIFY_OnChanged;
+	DOREPLIFETIME_WITH_PARAMS_FAST(ULifeAttributeSet, PackedLifePool, Params);
+}
+
+void ULifeAttributeSet::OnRep_PackedLifePool()
+{
+	using FOnRepAttribute = void (ULifeAttributeSet::*)(const FGameplayAttributeData&);
+
+	auto Unpack = [this](FGameplayAttributeData& Attribute, FLifePoolRepData::EField Field, FOnRepAttribute OnRep)
+	{
+		const float NewValue = PackedLifePool.GetValue(Field);
+		if (Attribute.GetCurrentValue() == NewValue)
+		{
+			return;
+		}
+
+		// Same as receiving the attribute on its own: write the value then run its RepNotify
+		const FGameplayAttributeData OldValue = Attribute;
+		Attribute.SetBaseValue(NewValue);
+		Attribute.SetCurrentValue(NewValue);
+		(this->*OnRep)(OldValue);
+	};
+
+	// Maxima first so listeners never see a value above its max
+	Unpack(MaxHealth,  FLifePoolRepData::MaxHealth,  &ULifeAttributeSet::OnRep_MaxHealth);
+	Unpack(MaxShields, FLifePoolRepData::MaxShields, &ULifeAttributeSet::OnRep_MaxShields);
+	Unpack(MaxArmor,   FLifePoolRepData::MaxArmor,   &ULifeAttributeSet::OnRep_MaxArmor);
+	Unpack(Health,     FLifePoolRepData::Health,     &ULifeAttributeSet::OnRep_Health);
+	Unpack(Shields,    FLifePoolRepData::Shields,    &ULifeAttributeSet::OnRep_Shields);
+	Unpack(Armor,      FLifePoolRepData::Armor,      &ULifeAttributeSet::OnRep_Armor);
+	Unpack(OverHealth, FLifePoolRepData::OverHealth, &ULifeAttributeSet::OnRep_OverHealth);
+	Unpack(OverArmor,  FLifePoolRepData::OverArmor,  &ULifeAttributeSet::OnRep_OverArmor);
 }
 
 void ULifeAttributeSet::OnRep_MaxHealth(const FGameplayAttributeData &OldMaxHealth)
@@ -0,0 +1,242 @@
+// Copyright Final Fall Games. All Rights Reserved.
+
+#include "core/gas/life_pool_kernel.h"
+
+//---------------------------------------------------------------------------------------------------------------------
+/// MARK: - FLifePoolSoA
+//---------------------------------------------------------------------------------------------------------------------
+
+void FLifePoolSoA::Reserve(int32 Count)
+{
+	OverArmor.Reserve(Count);
+	OverHealth.Reserve(Count);
+	Armor.Reserve(Count);
+	Shields.Reserve(Count);
+	Health.Reserve(Count);
+	MaxArmor.Reserve(Count);
+	MaxShields.Reserve(Count);
+	MaxHealth.Reserve(Count);
+}
+
+void FLifePoolSoA::Reset()
+{
+	OverArmor.Reset();
+	OverHealth.Reset();
+	Armor.Reset();
+	Shields.Reset();
+	Health.Reset();
+	MaxArmor.Reset();
+	MaxShields.Reset();
+	MaxHealth.Reset();
+}
+
+int32 FLifePoolSoA::Add(const FLifePoolValues& Pool)
+{
+	OverArmor.Add(Pool.OverArmor);
+	OverHealth.Add(Pool.OverHealth);
+	Armor.Add(Pool.Armor);
+	Shields.Add(Pool.Shields);
+	MaxArmor.Add(Pool.MaxArmor);
+	MaxShields.Add(Pool.MaxShields);
+	MaxHealth.Add(Pool.MaxHealth);
+	return Health.Add(Pool.Health);
+}
+
+FLifePoolValues FLifePoolSoA::Get(int32 Index) const
+{
+	FLifePoolValues Pool;
+	Pool.OverArmor  = OverArmor[Index];
+	Pool.OverHealth = OverHealth[Index];
+	Pool.Armor      = Armor[Index];
+	Pool.Shields    = Shields[Index];
+	Pool.Health     = Health[Index];
+	Pool.MaxArmor   = MaxArmor[Index];
+	Pool.MaxShields = MaxShields[Index];
+	Pool.MaxHealth  = MaxHealth[Index];
+	return Pool;
+}
+
+void FLifePoolSoA::Set(int32 Index, const FLifePoolValues& Pool)
+{
+	OverArmor[Index]  = Pool.OverArmor;
+	OverHealth[Index] = Pool.OverHealth;
+	Armor[Index]      = Pool.Armor;
+	Shields[Index]    = Pool.Shields;
+	Health[Index]     = Pool.Health;
+	MaxArmor[Index]   = Pool.MaxArmor;
+	MaxShields[Index] = Pool.MaxShields;
+	MaxHealth[Index]  = Pool.MaxHealth;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// MARK: - Single pool
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace
+{
+	/// Take as much of the remaining damage as the layer holds. Empty or negative layers are left untouched.
+	FORCEINLINE void DamageLayer(float& Layer, float& RemainingDamage)
+	{
+		const float AttributeDamage = FMath::Max<float>(FMath::Min<float>(Layer, RemainingDamage), 0.0f);
+		Layer -= AttributeDamage;
+		RemainingDamage -= AttributeDamage;
+	}
+
+	/// Fill the layer up to its max with as much of the remaining healing as it can take.
+	FORCEINLINE void HealLayer(float& Layer, const float MaxValue, float& RemainingHealing)
+	{
+		const float AttributeHealing = FMath::Max<float>(FMath::Min<float>(MaxValue - Layer, RemainingHealing), 0.0f);
+		Layer += AttributeHealing;
+		RemainingHealing -= AttributeHealing;
+	}
+
+	/// Same as DamageLayer but four pools at a time.
+	FORCEINLINE void DamageLayer4(float* Layer, VectorRegister4Float& RemainingDamage)
+	{
+		const auto Value = VectorLoad(Layer);
+		const auto AttributeDamage = VectorMax(VectorMin(Value, RemainingDamage), GlobalVectorConstants::FloatZero);
+		VectorStore(VectorSubtract(Value, AttributeDamage), Layer);
+		RemainingDamage = VectorSubtract(RemainingDamage, AttributeDamage);
+	}
+
+	/// Same as HealLayer but four pools at a time.
+	FORCEINLINE void HealLayer4(float* Layer, const float* MaxValue, VectorRegister4Float& RemainingHealing)
+	{
+		const auto Value = VectorLoad(Layer);
+		const auto Room = VectorSubtract(VectorLoad(MaxValue), Value);
+		const auto AttributeHealing = VectorMax(VectorMin(Room, RemainingHealing), GlobalVectorConstants::FloatZero);
+		VectorStore(VectorAdd(Value, AttributeHealing), Layer);
+		RemainingHealing = VectorSubtract(RemainingHealing, AttributeHealing);
+	}
+}
+
+float HeraLifePool::ApplyDamage(FLifePoolValues& Pool, float Damage)
+{
+	float RemainingDamage = FMath::Max<float>(Damage, 0.0f);
+
+	DamageLayer(Pool.OverArmor,  RemainingDamage);
+	DamageLayer(Pool.OverHealth, RemainingDamage);
+	DamageLayer(Pool.Armor,      RemainingDamage);
+	DamageLayer(Pool.Shields,    RemainingDamage);
+	DamageLayer(Pool.Health,     RemainingDamage);
+
+	return RemainingDamage;
+}
+
+float HeraLifePool::ApplyHealing(FLifePoolValues& Pool, float Healing)
+{
+	float RemainingHealing = FMath::Max<float>(Healing, 0.0f);
+
+	HealLayer(Pool.Health,  Pool.MaxHealth,  RemainingHealing);
+	HealLayer(Pool.Shields, Pool.MaxShields, RemainingHealing);
+	HealLayer(Pool.Armor,   Pool.MaxArmor,   RemainingHealing);
+
+	return RemainingHealing;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// MARK: - Many pools
+//---------------------------------------------------------------------------------------------------------------------
+
+void HeraLifePool::ApplyDamage(FLifePoolSoA& Pools, TArrayView<const float> DamagePerPool)
+{
+	const int32 Count = Pools.Num();
+	check(DamagePerPool.Num() == Count);
+
+	float* OverArmor  = Pools.OverArmor.GetData();
+	float* OverHealth = Pools.OverHealth.GetData();
+	float* Armor      = Pools.Armor.GetData();
+	float* Shields    = Pools.Shields.GetData();
+	float* Health     = Pools.Health.GetData();
+	const float* Damage = DamagePerPool.GetData();
+
+	int32 Index = 0;
+	for (; Index + 4 <= Count; Index += 4)
+	{
+		auto RemainingDamage = VectorMax(VectorLoad(Damage + Index), GlobalVectorConstants::FloatZero);
+
+		DamageLayer4(OverArmor  + Index, RemainingDamage);
+		DamageLayer4(OverHealth + Index, RemainingDamage);
+		DamageLayer4(Armor      + Index, RemainingDamage);
+		DamageLayer4(Shields    + Index, RemainingDamage);
+		DamageLayer4(Health     + Index, RemainingDamage);
+	}
+
+	for (; Index < Count; ++Index)
+	{
+		float RemainingDamage = FMath::Max<float>(Damage[Index], 0.0f);
+
+		DamageLayer(OverArmor[Index],  RemainingDamage);
+		DamageLayer(OverHealth[Index], RemainingDamage);
+		DamageLayer(Armor[Index],      RemainingDamage);
+		DamageLayer(Shields[Index],    RemainingDamage);
+		DamageLayer(Health[Index],     RemainingDamage);
+	}
+}
+
+void HeraLifePool::ApplyHealing(FLifePoolSoA& Pools, TArrayView<const float> HealingPerPool)
+{
+	const int32 Count = Pools.Num();
+	check(HealingPerPool.Num() == Count);
+
+	float* Health     = Pools.Health.GetData();
+	float* Shields    = Pools.Shields.GetData();
+	float* Armor      = Pools.Armor.GetData();
+	const float* MaxHealth  = Pools.MaxHealth.GetData();
+	const float* MaxShields = Pools.MaxShields.GetData();
+	const float* MaxArmor   = Pools.MaxArmor.GetData();
+	const float* Healing = HealingPerPool.GetData();
+
+	int32 Index = 0;
+	for (; Index + 4 <= Count; Index += 4)
+	{
+		auto RemainingHealing = VectorMax(VectorLoad(Healing + Index), GlobalVectorConstants::FloatZero);
+
+		HealLayer4(Health  + Index, MaxHealth  + Index, RemainingHealing);
+		HealLayer4(Shields + Index, MaxShields + Index, RemainingHealing);
+		HealLayer4(Armor   + Index, MaxArmor   + Index, RemainingHealing);
+	}
+
+	for (; Index < Count; ++Index)
+	{
+		float RemainingHealing = FMath::Max<float>(Healing[Index], 0.0f);
+
+		HealLayer(Health[Index],  MaxHealth[Index],  RemainingHealing);
+		HealLayer(Shields[Index], MaxShields[Index], RemainingHealing);
+		HealLayer(Armor[Index],   MaxArmor[Index],   RemainingHealing);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// MARK: - Batched events
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace
+{
+	/// Sum event amounts per pool. Scratch ends up with exactly one entry per pool.
+	void AccumulateEvents(const int32 PoolCount, TArrayView<const FLifePoolEvent> Events, TArray<float>& Scratch)
+	{
+		Scratch.Reset();
+		Scratch.SetNumZeroed(PoolCount);
+
+		for (const auto& Event : Events)
+		{
+			if (Scratch.IsValidIndex(Event.PoolIndex) && Event.Amount > 0.0f)
+			{
+				Scratch[Event.PoolIndex] += Event.Amount;
+			}
+		}
+	}
+}
+
+void HeraLifePool::ResolveDamage(FLifePoolSoA& Pools, TArrayView<const FLifePoolEvent> Events, TArray<float>& Scratch)
+{
+	AccumulateEvents(Pools.Num(), Events, Scratch);
+	ApplyDamage(Pools, Scratch);
+}
+
+void HeraLifePool::ResolveHealing(FLifePoolSoA& Pools, TArrayView<const FLifePoolEvent> Events, TArray<float>& Scratch)
+{
+	AccumulateEvents(Pools.Num(), Events, Scratch);
+	ApplyHealing(Pools, Scratch);
+}
@@ -0,0 +1,28 @@
+// Copyright Final Fall Games. All Rights Reserved.
+
+#include "core/hera_collision.h"
+
+#include "Engine/CollisionProfile.h"
+
+namespace HeraCollision
+{
+	const FName kProjectileProfile(TEXT("Projectile"));
+
+	ECollisionChannel GetProjectileChannel()
+	{
+		// Profiles are loaded from config once, look the channel up the first time it's needed
+		static const ECollisionChannel kProjectileChannel = []()
+		{
+			FCollisionResponseTemplate Template;
+			if (!UCollisionProfile::Get()->GetProfileTemplate(kProjectileProfile, Template))
+			{
+				UE_LOG(LogTemp, Error, TEXT("%s() No %s collision profile, using WorldDynamic"), *FString(__FUNCTION__), *kProjectileProfile.ToString());
+				return ECC_WorldDynamic;
+			}
+
+			return Template.ObjectType;
+		}();
+
+		return kProjectileChannel;
+	}
+}
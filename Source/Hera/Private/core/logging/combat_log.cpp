@@ -0,0 +1,269 @@
+// Copyright Final Fall Games. All Rights Reserved.
+
+#include "core/logging/combat_log.h"
+
+#include "HAL/FileManager.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/Event.h"
+#include "Misc/DateTime.h"
+
+/// How long the writer thread sleeps between drains when nobody wakes it up.
+static constexpr uint32 kCombatLogFlushIntervalMs = 250;
+
+/// Most events moved to the file per Events block.
+static constexpr int32 kCombatLogMaxEventsPerBlock = 4096;
+
+FArchive& operator<<(FArchive& Ar, FCombatLogHeader& Header)
+{
+	Ar << Header.Magic;
+	Ar << Header.Version;
+	Ar << Header.EventSize;
+	Ar << Header.StartTicks;
+	return Ar;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// MARK: - FCombatLogRing
+//---------------------------------------------------------------------------------------------------------------------
+
+FCombatLogRing::FCombatLogRing(uint32 Capacity)
+{
+	const uint32 Size = FMath::RoundUpToPowerOfTwo(FMath::Max<uint32>(Capacity, 2));
+	Events.SetNumZeroed(Size);
+	Mask = Size - 1;
+}
+
+bool FCombatLogRing::Push(const FCombatLogEvent& Event)
+{
+	const uint32 CurrentHead = Head.load(std::memory_order_relaxed);
+	const uint32 CurrentTail = Tail.load(std::memory_order_acquire);
+	if (CurrentHead - CurrentTail > Mask)
+	{
+		DroppedCount.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	Events[CurrentHead & Mask] = Event;
+
+	// Publish the slot to the consumer
+	Head.store(CurrentHead + 1, std::memory_order_release);
+	return true;
+}
+
+int32 FCombatLogRing::Pop(TArray<FCombatLogEvent>& OutEvents, int32 MaxCount)
+{
+	const uint32 CurrentTail = Tail.load(std::memory_order_relaxed);
+	const uint32 CurrentHead = Head.load(std::memory_order_acquire);
+	const int32 Count = FMath::Min<int32>(static_cast<int32>(CurrentHead - CurrentTail), MaxCount);
+	if (Count <= 0)
+	{
+		return 0;
+	}
+
+	// Copy in at most two runs, before and after the wrap
+	const uint32 Start = CurrentTail & Mask;
+	const int32 FirstRun = FMath::Min<int32>(Count, Events.Num() - Start);
+	OutEvents.Append(Events.GetData() + Start, FirstRun);
+	OutEvents.Append(Events.GetData(), Count - FirstRun);
+
+	// Hand the slots back to the producer
+	Tail.store(CurrentTail + Count, std::memory_order_release);
+	return Count;
+}
+
+bool FCombatLogRing::IsEmpty() const
+{
+	return Head.load(std::memory_order_acquire) == Tail.load(std::memory_order_acquire);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// MARK: - FCombatLogWriter
+//---------------------------------------------------------------------------------------------------------------------
+
+FCombatLogWriter::FCombatLogWriter(const FString& InFilename, uint32 Capacity)
+: Filename(InFilename)
+, Ring(Capacity)
+{
+	DrainBuffer.Reserve(kCombatLogMaxEventsPerBlock);
+	WakeEvent = FPlatformProcess::GetSynchEventFromPool();
+	Thread = FRunnableThread::Create(this, TEXT("HeraCombatLogWriter"), 0, TPri_BelowNormal);
+}
+
+FCombatLogWriter::~FCombatLogWriter()
+{
+	if (Thread)
+	{
+		// Kill calls Stop and waits for Run to write what's left
+		Thread->Kill(true);
+		delete Thread;
+		Thread = nullptr;
+	}
+
+	FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+	WakeEvent = nullptr;
+}
+
+void FCombatLogWriter::Log(const FCombatLogEvent& Event)
+{
+	Ring.Push(Event);
+}
+
+void FCombatLogWriter::AddName(uint32 ActorId, const FString& Name)
+{
+	PendingNames.Enqueue({ ActorId, Name });
+}
+
+uint32 FCombatLogWriter::Run()
+{
+	TUniquePtr<FArchive> Ar(IFileManager::Get().CreateFileWriter(*Filename, FILEWRITE_AllowRead));
+	if (!Ar)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Combat log: couldn't open %s"), *Filename);
+		return 1;
+	}
+
+	FCombatLogHeader Header;
+	Header.StartTicks = FDateTime::UtcNow().GetTicks();
+	*Ar << Header;
+
+	while (!IsStopping.load(std::memory_order_acquire))
+	{
+		WakeEvent->Wait(kCombatLogFlushIntervalMs);
+		Drain(*Ar);
+
+		// Keep the file usable if the process dies mid-match
+		Ar->Flush();
+	}
+
+	// Everything logged before Stop was called
+	Drain(*Ar);
+
+	uint8 Block = static_cast<uint8>(ECombatLogBlock::End);
+	uint32 Count = 0;
+	*Ar << Block;
+	*Ar << Count;
+	Ar->Close();
+
+	return 0;
+}
+
+void FCombatLogWriter::Stop()
+{
+	IsStopping.store(true, std::memory_order_release);
+	WakeEvent->Trigger();
+}
+
+void FCombatLogWriter::Drain(FArchive& Ar)
+{
+	FPendingName PendingName;
+	TArray<FPendingName> Names;
+	while (PendingNames.Dequeue(PendingName))
+	{
+		Names.Add(MoveTemp(PendingName));
+	}
+
+	if (Names.Num() > 0)
+	{
+		uint8 Block = static_cast<uint8>(ECombatLogBlock::Names);
+		uint32 Count = Names.Num();
+		Ar << Block;
+		Ar << Count;
+		for (auto& Name : Names)
+		{
+			Ar << Name.ActorId;
+			Ar << Name.Name;
+		}
+	}
+
+	while (!Ring.IsEmpty())
+	{
+		DrainBuffer.Reset();
+		Ring.Pop(DrainBuffer, kCombatLogMaxEventsPerBlock);
+
+		uint8 Block = static_cast<uint8>(ECombatLogBlock::Events);
+		uint32 Count = DrainBuffer.Num();
+		Ar << Block;
+		Ar << Count;
+		Ar.Serialize(DrainBuffer.GetData(), DrainBuffer.Num() * sizeof(FCombatLogEvent));
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// MARK: - FCombatLogReader
+//---------------------------------------------------------------------------------------------------------------------
+
+FString FCombatLogFile::GetName(uint32 ActorId) const
+{
+	if (const auto Name = Names.Find(ActorId))
+	{
+		return *Name;
+	}
+
+	return FString::Printf(TEXT("#%u"), ActorId);
+}
+
+bool FCombatLogReader::ReadFile(const FString& Filename, FCombatLogFile& OutFile)
+{
+	OutFile = FCombatLogFile();
+
+	TUniquePtr<FArchive> Ar(IFileManager::Get().CreateFileReader(*Filename, FILEREAD_AllowWrite));
+	if (!Ar)
+	{
+		return false;
+	}
+
+	*Ar << OutFile.Header;
+	if (Ar->IsError()
+		|| OutFile.Header.Magic != kCombatLogMagic
+		|| OutFile.Header.Version != kCombatLogVersion
+		|| OutFile.Header.EventSize != sizeof(FCombatLogEvent))
+	{
+		return false;
+	}
+
+	// A block header is a byte and a uint32
+	const int64 BlockHeaderSize = sizeof(uint8) + sizeof(uint32);
+
+	while (Ar->TotalSize() - Ar->Tell() >= BlockHeaderSize)
+	{
+		uint8 Block = 0;
+		uint32 Count = 0;
+		*Ar << Block;
+		*Ar << Count;
+
+		if (Block == static_cast<uint8>(ECombatLogBlock::Events))
+		{
+			const int64 Bytes = static_cast<int64>(Count) * sizeof(FCombatLogEvent);
+			if (Ar->TotalSize() - Ar->Tell() < Bytes)
+			{
+				break;
+			}
+
+			const int32 Start = OutFile.Events.AddUninitialized(Count);
+			Ar->Serialize(OutFile.Events.GetData() + Start, Bytes);
+		}
+		else if (Block == static_cast<uint8>(ECombatLogBlock::Names))
+		{
+			for (uint32 Index = 0; Index < Count && !Ar->IsError(); ++Index)
+			{
+				uint32 ActorId = 0;
+				FString Name;
+				*Ar << ActorId;
+				*Ar << Name;
+				OutFile.Names.Add(ActorId, MoveTemp(Name));
+			}
+		}
+		else
+		{
+			// End, or something this version doesn't know about
+			break;
+		}
+
+		if (Ar->IsError())
+		{
+			break;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,224 @@
+// Copyright Final Fall Games. All Rights Reserved.
+
+#include "core/subsystems/combat_log_subsystem.h"
+
+#include "AbilitySystemComponent.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Paths.h"
+
+static TAutoConsoleVariable<int32> CVarCombatLog(
+	TEXT("Hera.CombatLog"),
+	0,
+	TEXT("Record every damage, healing and kill event of a match to Saved/CombatLogs.\n")
+	TEXT("Read when a world begins play, only on the server or in standalone games.\n")
+	TEXT("0: Off (default)\n")
+	TEXT("1: On"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<int32> CVarCombatLogCapacity(
+	TEXT("Hera.CombatLog.Capacity"),
+	65536,
+	TEXT("Events the combat log can hold before the writer thread catches up. Events beyond it are dropped."),
+	ECVF_Default
+);
+
+//---------------------------------------------------------------------------------------------------------------------
+/// MARK: - UCombatLogSubsystem
+//---------------------------------------------------------------------------------------------------------------------
+
+UCombatLogSubsystem* UCombatLogSubsystem::Get(const UObject* WorldContextObject)
+{
+	const auto World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	const auto CombatLog = World ? World->GetSubsystem<UCombatLogSubsystem>() : nullptr;
+	return CombatLog && CombatLog->IsRecording() ? CombatLog : nullptr;
+}
+
+bool UCombatLogSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCombatLogSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// Clients don't run the executions, so they'd only log what they predicted
+	if (CVarCombatLog.GetValueOnGameThread() <= 0
+		|| InWorld.GetNetMode() == NM_Client
+		|| !FPlatformProcess::SupportsMultithreading())
+	{
+		return;
+	}
+
+	const auto Filename = FPaths::Combine(
+		FPaths::ProjectSavedDir(),
+		TEXT("CombatLogs"),
+		FString::Printf(TEXT("CombatLog-%s-%s.hclog"), *InWorld.GetMapName(), *FDateTime::Now().ToString())
+	);
+
+	Writer = MakeUnique<FCombatLogWriter>(Filename, CVarCombatLogCapacity.GetValueOnGameThread());
+	UE_LOG(LogTemp, Log, TEXT("Combat log: recording to %s"), *Filename);
+}
+
+void UCombatLogSubsystem::Deinitialize()
+{
+	if (Writer)
+	{
+		const auto DroppedCount = Writer->GetDroppedCount();
+		if (DroppedCount > 0)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Combat log: dropped %u events. Raise Hera.CombatLog.Capacity."), DroppedCount);
+		}
+
+		// Waits for the writer thread to finish the file
+		Writer.Reset();
+	}
+
+	ActorIds.Reset();
+	NextActorId = 1;
+
+	Super::Deinitialize();
+}
+
+void UCombatLogSubsystem::LogDamage(
+	const UAbilitySystemComponent* SourceASC,
+	const UAbilitySystemComponent* TargetASC,
+	float UnmitigatedDamage,
+	float FinalDamage
+)
+{
+	Log(ECombatLogEventType::Damage, SourceASC, TargetASC, UnmitigatedDamage, FinalDamage);
+}
+
+void UCombatLogSubsystem::LogHealing(
+	const UAbilitySystemComponent* SourceASC,
+	const UAbilitySystemComponent* TargetASC,
+	float UnmitigatedHealing,
+	float FinalHealing
+)
+{
+	Log(ECombatLogEventType::Healing, SourceASC, TargetASC, UnmitigatedHealing, FinalHealing);
+}
+
+void UCombatLogSubsystem::LogKill(const UAbilitySystemComponent* SourceASC, const UAbilitySystemComponent* TargetASC)
+{
+	Log(ECombatLogEventType::Kill, SourceASC, TargetASC, 0.0f, 0.0f);
+}
+
+void UCombatLogSubsystem::Log(
+	ECombatLogEventType Type,
+	const UAbilitySystemComponent* SourceASC,
+	const UAbilitySystemComponent* TargetASC,
+	float UnmitigatedAmount,
+	float FinalAmount
+)
+{
+	if (!Writer)
+	{
+		return;
+	}
+
+	FCombatLogEvent Event;
+	Event.Type = Type;
+	Event.Frame = static_cast<uint32>(GFrameCounter);
+	Event.Time = GetWorld()->GetTimeSeconds();
+	Event.SourceId = GetActorId(SourceASC);
+	Event.TargetId = GetActorId(TargetASC);
+	Event.UnmitigatedAmount = UnmitigatedAmount;
+	Event.FinalAmount = FinalAmount;
+	Writer->Log(Event);
+}
+
+uint32 UCombatLogSubsystem::GetActorId(const UAbilitySystemComponent* ASC)
+{
+	const AActor* Actor = ASC ? ASC->GetAvatarActor_Direct() : nullptr;
+	if (!Actor)
+	{
+		return 0;
+	}
+
+	if (const uint32* ActorId = ActorIds.Find(Actor))
+	{
+		return *ActorId;
+	}
+
+	const uint32 ActorId = NextActorId++;
+	ActorIds.Add(Actor, ActorId);
+	Writer->AddName(ActorId, Actor->GetName());
+
+	return ActorId;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// MARK: - Offline analysis
+//---------------------------------------------------------------------------------------------------------------------
+
+/// Per actor totals of a combat log, printed to the output log.
+static void SummarizeCombatLog(const TArray<FString>& Args)
+{
+	if (Args.Num() < 1)
+	{
+		UE_LOG(LogTemp, Display, TEXT("Usage: Hera.CombatLog.Summarize <path to .hclog>"));
+		return;
+	}
+
+	FCombatLogFile File;
+	if (!FCombatLogReader::ReadFile(Args[0], File))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Combat log: couldn't read %s"), *Args[0]);
+		return;
+	}
+
+	struct FTotals
+	{
+		float DamageDealt = 0.0f;
+		float DamageTaken = 0.0f;
+		float HealingDone = 0.0f;
+		int32 Kills = 0;
+		int32 Deaths = 0;
+	};
+
+	TMap<uint32, FTotals> Totals;
+	for (const auto& Event : File.Events)
+	{
+		auto& Source = Totals.FindOrAdd(Event.SourceId);
+		auto& Target = Totals.FindOrAdd(Event.TargetId);
+		switch (Event.Type)
+		{
+		case ECombatLogEventType::Damage:
+			Source.DamageDealt += Event.FinalAmount;
+			Target.DamageTaken += Event.FinalAmount;
+			break;
+
+		case ECombatLogEventType::Healing:
+			Source.HealingDone += Event.FinalAmount;
+			break;
+
+		case ECombatLogEventType::Kill:
+			Source.Kills++;
+			Target.Deaths++;
+			break;
+		}
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Combat log %s: %d events, %d actors"), *Args[0], File.Events.Num(), File.Names.Num());
+	for (const auto& Pair : Totals)
+	{
+		UE_LOG(LogTemp, Display, TEXT("  %-40s dealt %10.1f  taken %10.1f  healed %10.1f  kills %4d  deaths %4d"),
+			*File.GetName(Pair.Key),
+			Pair.Value.DamageDealt,
+			Pair.Value.DamageTaken,
+			Pair.Value.HealingDone,
+			Pair.Value.Kills,
+			Pair.Value.Deaths
+		);
+	}
+}
+
+static FAutoConsoleCommand SummarizeCombatLogCommand(
+	TEXT("Hera.CombatLog.Summarize"),
+	TEXT("Print per actor damage, healing, kills and deaths from a combat log file."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&SummarizeCombatLog)
+);
@@ -0,0 +1,173 @@
+// Copyright Final Fall Games. All Rights Reserved.
+
+#include "core/subsystems/cosmetic_feedback_subsystem.h"
+#include "core/hera_stats.h"
+
+#include "Animation/AnimInstance.h"
+#include "Animation/AnimMontage.h"
+#include "Components/AudioComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "Sound/SoundBase.h"
+
+DECLARE_CYCLE_STAT(TEXT("CosmeticFeedbackFlush"), STAT_Hera_CosmeticFeedbackFlush, STATGROUP_Hera);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Fire feedback coalesced"), STAT_Hera_FireFeedbackCoalesced, STATGROUP_Hera);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Fire sounds cut off"), STAT_Hera_FireSoundsCutOff, STATGROUP_Hera);
+
+static TAutoConsoleVariable<int32> CVarMaxAudioComponents(
+	TEXT("Hera.Cosmetics.MaxAudioComponents"),
+	24,
+	TEXT("Most pooled audio components for weapon fire. Past it the oldest sound is cut off."),
+	ECVF_Default
+);
+
+/// Sounds started this close to one already queued this frame play as that one, in cm.
+static constexpr float kCoalesceDistance = 100.0f;
+
+bool UCosmeticFeedbackSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+bool UCosmeticFeedbackSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UCosmeticFeedbackSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCosmeticFeedbackSubsystem, STATGROUP_Tickables);
+}
+
+void UCosmeticFeedbackSubsystem::Deinitialize()
+{
+	// The components are destroyed with the world
+	Pending.Reset();
+	AudioComponents.Reset();
+
+	Super::Deinitialize();
+}
+
+void UCosmeticFeedbackSubsystem::QueueFireFeedback(
+	USoundBase* Sound, 
+	UAnimMontage* Montage, 
+	USkeletalMeshComponent* Mesh, 
+	const FVector& Location
+)
+{
+	// A dedicated server in PIE still has this subsystem
+	if (GetWorld()->GetNetMode() == NM_DedicatedServer || (!Sound && !Montage))
+	{
+		return;
+	}
+
+	for (auto& Feedback : Pending)
+	{
+		const bool SameSound = !Sound || (Feedback.Sound == Sound && FVector::DistSquared(Feedback.Location, Location) <= FMath::Square(kCoalesceDistance));
+		const bool SameMontage = !Montage || (Feedback.Montage == Montage && Feedback.Mesh == Mesh);
+		if (SameSound && SameMontage)
+		{
+			INC_DWORD_STAT(STAT_Hera_FireFeedbackCoalesced);
+			return;
+		}
+	}
+
+	FFireFeedback& Feedback = Pending.AddDefaulted_GetRef();
+	Feedback.Sound = Sound;
+	Feedback.Montage = Montage;
+	Feedback.Mesh = Mesh;
+	Feedback.Location = Location;
+}
+
+void UCosmeticFeedbackSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (Pending.Num() > 0)
+	{
+		Flush();
+	}
+}
+
+void UCosmeticFeedbackSubsystem::Flush()
+{
+	HERA_SCOPE_CYCLE_COUNTER(CosmeticFeedbackFlush);
+
+	for (const auto& Feedback : Pending)
+	{
+		if (const auto Sound = Feedback.Sound.Get())
+		{
+			PlaySound(Sound, Feedback.Location);
+		}
+
+		const auto Montage = Feedback.Montage.Get();
+		const auto Mesh = Feedback.Mesh.Get();
+		if (const auto AnimInstance = Montage && Mesh ? Mesh->GetAnimInstance() : nullptr)
+		{
+			AnimInstance->Montage_Play(Montage, 1.f);
+		}
+	}
+
+	Pending.Reset();
+}
+
+void UCosmeticFeedbackSubsystem::PlaySound(USoundBase* Sound, const FVector& Location)
+{
+	if (const auto AudioComponent = AcquireAudioComponent(Sound, Location))
+	{
+		AudioComponent->SetSound(Sound);
+		AudioComponent->SetWorldLocation(Location);
+		AudioComponent->Play();
+	}
+}
+
+UAudioComponent* UCosmeticFeedbackSubsystem::AcquireAudioComponent(USoundBase* Sound, const FVector& Location)
+{
+	// Drop anything destroyed behind our back, e.g. by a level streaming out
+	AudioComponents.RemoveAll([](const UAudioComponent* AudioComponent) { return !IsValid(AudioComponent); });
+
+	for (const auto& AudioComponent : AudioComponents)
+	{
+		if (!AudioComponent->IsPlaying())
+		{
+			return AudioComponent;
+		}
+	}
+
+	if (AudioComponents.Num() < CVarMaxAudioComponents.GetValueOnGameThread())
+	{
+		// Not auto destroyed, it goes back to the pool when it's done playing
+		const auto AudioComponent = UGameplayStatics::SpawnSoundAtLocation(
+			this, 
+			Sound, 
+			Location, 
+			FRotator::ZeroRotator, 
+			1.0f, 
+			1.0f, 
+			0.0f, 
+			nullptr, 
+			nullptr, 
+			false
+		);
+		if (AudioComponent)
+		{
+			AudioComponent->Stop();
+			AudioComponents.Add(AudioComponent);
+		}
+		return AudioComponent;
+	}
+
+	if (AudioComponents.Num() == 0)
+	{
+		return nullptr;
+	}
+
+	// Every component is busy. Cut off the one started longest ago.
+	INC_DWORD_STAT(STAT_Hera_FireSoundsCutOff);
+	NextToSteal = NextToSteal % AudioComponents.Num();
+	const auto AudioComponent = AudioComponents[NextToSteal++].Get();
+	AudioComponent->Stop();
+	return AudioComponent;
+}
@@ -0,0 +1,446 @@
+// Copyright Final Fall Games. All Rights Reserved.
+
+#include "core/subsystems/healthbar_subsystem.h"
+#include "core/subsystems/significance_subsystem.h"
+#include "core/actors/base_character_actor.h"
+#include "core/ui/healthbar_widget.h"
+#include "core/hera_stats.h"
+
+#include "Components/CapsuleComponent.h"
+#include "Blueprint/UserWidget.h"
+#include "Engine/AssetManager.h"
+#include "Engine/GameViewportClient.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("HealthbarGather"), STAT_Hera_HealthbarGather, STATGROUP_Hera);
+DECLARE_CYCLE_STAT(TEXT("HealthbarFlush"), STAT_Hera_HealthbarFlush, STATGROUP_Hera);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Healthbars drawn"), STAT_Hera_HealthbarsDrawn, STATGROUP_Hera);
+DECLARE_CYCLE_STAT(TEXT("HealthbarPool"), STAT_Hera_HealthbarPool, STATGROUP_Hera);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Healthbars flushed"), STAT_Hera_HealthbarsFlushed, STATGROUP_Hera);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Healthbars rebound"), STAT_Hera_HealthbarsRebound, STATGROUP_Hera);
+
+static TAutoConsoleVariable<int32> CVarHealthbarMode(
+	TEXT("Hera.UI.HealthbarMode"),
+	1,
+	TEXT("How floating healthbars are drawn. 0: a widget component per character. 1: one overlay for every character. "
+		"2: a fixed pool of widgets for the most relevant characters."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarHealthbarFlushRate(
+	TEXT("Hera.UI.HealthbarFlushRate"),
+	0.0f,
+	TEXT("Most times a second changed life pools are pushed to their healthbars. 0 pushes them every frame."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<int32> CVarHealthbarPoolSize(
+	TEXT("Hera.UI.HealthbarPoolSize"),
+	12,
+	TEXT("Healthbar widgets in the pool of Hera.UI.HealthbarMode 2, so the most characters with a healthbar at once."),
+	ECVF_Default
+);
+
+/// Under the rest of the HUD, which is added at z-order 0 and up.
+static constexpr int32 kOverlayZOrder = -10;
+
+/// Gap between the top of the capsule and the bar, in cm.
+static constexpr float kBarHeadroom = 20.0f;
+
+/// Bars are full size up to this distance from the view and shrink past it, in cm.
+static constexpr float kFullScaleDistance = 1500.0f;
+static constexpr float kMinScale = 0.5f;
+
+/// Characters rendered within this many seconds count as on screen.
+static constexpr float kRecentlyRenderedSeconds = 0.2f;
+
+EHealthbarMode UHealthbarSubsystem::GetMode()
+{
+	switch (CVarHealthbarMode.GetValueOnGameThread())
+	{
+	case 0:
+		return EHealthbarMode::PerActor;
+	case 2:
+		return EHealthbarMode::Pooled;
+	default:
+		return EHealthbarMode::Batched;
+	}
+}
+
+bool UHealthbarSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+bool UHealthbarSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UHealthbarSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UHealthbarSubsystem, STATGROUP_Tickables);
+}
+
+void UHealthbarSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	const auto& WidgetClass = GetDefault<ACharacterBase>()->GetHealthbarWidgetSoftClass();
+	if (GetMode() != EHealthbarMode::Batched && WidgetClass.IsPending() && UAssetManager::IsValid())
+	{
+		WidgetClassHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(WidgetClass.ToSoftObjectPath());
+	}
+}
+
+void UHealthbarSubsystem::Deinitialize()
+{
+	RemoveOverlay();
+	Characters.Reset();
+	DirtyCharacters.Reset();
+
+	for (const auto& Widget : PooledWidgets)
+	{
+		if (Widget)
+		{
+			Widget->RemoveFromParent();
+		}
+	}
+	PooledWidgets.Reset();
+	PooledCharacters.Reset();
+	WidgetClassHandle.Reset();
+	PooledWidgetClassHandle.Reset();
+
+	Super::Deinitialize();
+}
+
+void UHealthbarSubsystem::Register(ACharacterBase* Character)
+{
+	if (!Character)
+	{
+		return;
+	}
+
+	Characters.AddUnique(Character);
+	if (PooledWidgetSoftClass.IsNull())
+	{
+		PooledWidgetSoftClass = Character->GetHealthbarWidgetSoftClass();
+	}
+}
+
+void UHealthbarSubsystem::Unregister(ACharacterBase* Character)
+{
+	Characters.RemoveSwap(Character);
+	DirtyCharacters.RemoveSwap(Character);
+}
+
+void UHealthbarSubsystem::MarkDirty(ACharacterBase* Character)
+{
+	if (Character)
+	{
+		DirtyCharacters.AddUnique(Character);
+	}
+}
+
+void UHealthbarSubsystem::FlushDirty()
+{
+	HERA_SCOPE_CYCLE_COUNTER(HealthbarFlush);
+
+	int32 NumFlushed = 0;
+	for (int32 Index = DirtyCharacters.Num() - 1; Index >= 0; --Index)
+	{
+		const auto Character = DirtyCharacters[Index].Get();
+		if (!Character)
+		{
+			DirtyCharacters.RemoveAtSwap(Index, 1, false);
+			continue;
+		}
+
+		// Nobody sees it change. It catches up when it's back on screen.
+		if (Character->GetSignificance() == ESignificance::Culled
+			|| !Character->WasRecentlyRendered(kRecentlyRenderedSeconds))
+		{
+			continue;
+		}
+
+		Character->SetHealthbarSnapshot(FHealthbarSnapshot::FromCharacter(Character));
+
+		const int32 PoolIndex = PooledCharacters.IndexOfByKey(Character);
+		if (PoolIndex != INDEX_NONE)
+		{
+			PooledWidgets[PoolIndex]->ApplySnapshot(Character->GetHealthbarSnapshot());
+		}
+		DirtyCharacters.RemoveAtSwap(Index, 1, false);
+		++NumFlushed;
+	}
+
+	INC_DWORD_STAT_BY(STAT_Hera_HealthbarsFlushed, NumFlushed);
+}
+
+bool UHealthbarSubsystem::AddOverlay()
+{
+	if (Overlay.IsValid())
+	{
+		return true;
+	}
+
+	const auto GameViewport = GetWorld()->GetGameViewport();
+	if (!GameViewport)
+	{
+		return false;
+	}
+
+	GameViewport->AddViewportWidgetContent(SAssignNew(Overlay, SHealthbarOverlay), kOverlayZOrder);
+	return true;
+}
+
+void UHealthbarSubsystem::RemoveOverlay()
+{
+	if (!Overlay.IsValid())
+	{
+		return;
+	}
+
+	if (const auto GameViewport = GetWorld()->GetGameViewport())
+	{
+		GameViewport->RemoveViewportWidgetContent(Overlay.ToSharedRef());
+	}
+	Overlay.Reset();
+}
+
+void UHealthbarSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const float FlushRate = CVarHealthbarFlushRate.GetValueOnGameThread();
+	TimeSinceFlush += DeltaTime;
+	if (DirtyCharacters.Num() > 0 && (FlushRate <= 0.0f || TimeSinceFlush >= 1.0f / FlushRate))
+	{
+		FlushDirty();
+		TimeSinceFlush = 0.0f;
+	}
+
+	Characters.RemoveAllSwap([](const TWeakObjectPtr<ACharacterBase>& Character) { return !Character.IsValid(); });
+	if (Characters.Num() == 0 && !Overlay.IsValid() && PooledWidgets.Num() == 0)
+	{
+		return;
+	}
+
+	// Registered characters can switch between the batched and pooled paths at any time
+	VisibleHealthbars.Reset();
+	GatherVisibleHealthbars(VisibleHealthbars);
+
+	if (GetMode() == EHealthbarMode::Pooled)
+	{
+		RemoveOverlay();
+		UpdatePool(VisibleHealthbars);
+		return;
+	}
+
+	UpdatePool({});
+	if (!AddOverlay())
+	{
+		return;
+	}
+
+	TArray<FHealthbarDrawData> Healthbars;
+	Healthbars.Reserve(VisibleHealthbars.Num());
+	for (const auto& Visible : VisibleHealthbars)
+	{
+		// The whole bar is the maximum of every pool plus whatever over-pools are up
+		const auto& Snapshot = Visible.Character->GetHealthbarSnapshot();
+		const float Total = Snapshot.MaxHealth + Snapshot.MaxArmor + Snapshot.MaxShields 
+			+ Snapshot.OverHealth + Snapshot.OverArmor;
+
+		FHealthbarDrawData& Healthbar = Healthbars.AddDefaulted_GetRef();
+		Healthbar.Position = FVector2f(Visible.ScreenPosition);
+		Healthbar.Scale = Visible.Scale;
+		Healthbar.Health = Snapshot.Health / Total;
+		Healthbar.Armor = Snapshot.Armor / Total;
+		Healthbar.Shields = Snapshot.Shields / Total;
+		Healthbar.OverHealth = Snapshot.OverHealth / Total;
+		Healthbar.OverArmor = Snapshot.OverArmor / Total;
+	}
+
+	INC_DWORD_STAT_BY(STAT_Hera_HealthbarsDrawn, Healthbars.Num());
+	Overlay->SetHealthbars(MoveTemp(Healthbars));
+}
+
+void UHealthbarSubsystem::GatherVisibleHealthbars(TArray<FVisibleHealthbar>& OutHealthbars) const
+{
+	HERA_SCOPE_CYCLE_COUNTER(HealthbarGather);
+
+	const auto PlayerController = GetWorld()->GetFirstPlayerController();
+	if (!PlayerController || !PlayerController->IsLocalController())
+	{
+		return;
+	}
+
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+	for (const auto& WeakCharacter : Characters)
+	{
+		const auto Character = WeakCharacter.Get();
+		if (Character->IsLocallyControlled()
+			|| Character->GetSignificance() == ESignificance::Culled
+			|| !Character->WasRecentlyRendered(kRecentlyRenderedSeconds))
+		{
+			continue;
+		}
+
+		// Nothing to show for the dead, or without a life pool
+		const auto& Snapshot = Character->GetHealthbarSnapshot();
+		const float Total = Snapshot.MaxHealth + Snapshot.MaxArmor + Snapshot.MaxShields 
+			+ Snapshot.OverHealth + Snapshot.OverArmor;
+		if (Total <= 0.0f || FMath::Floor(Snapshot.Health) <= 0.0f)
+		{
+			continue;
+		}
+
+		const auto Capsule = Character->GetCapsuleComponent();
+		const FVector Anchor = Capsule->GetComponentLocation()
+			+ FVector::UpVector * (Capsule->GetScaledCapsuleHalfHeight() + kBarHeadroom);
+
+		FVector2D ScreenPosition;
+		if (!PlayerController->ProjectWorldLocationToScreen(Anchor, ScreenPosition, true))
+		{
+			continue;
+		}
+
+		const float Distance = FVector::Dist(ViewLocation, Anchor);
+		FVisibleHealthbar& Healthbar = OutHealthbars.AddDefaulted_GetRef();
+		Healthbar.Character = Character;
+		Healthbar.ScreenPosition = ScreenPosition;
+		Healthbar.Scale = FMath::Clamp(kFullScaleDistance / FMath::Max(Distance, 1.0f), kMinScale, 1.0f);
+		Healthbar.Distance = Distance;
+	}
+}
+
+void UHealthbarSubsystem::UpdatePool(TArrayView<FVisibleHealthbar> Visible)
+{
+	HERA_SCOPE_CYCLE_COUNTER(HealthbarPool);
+
+	const int32 PoolSize = FMath::Max(CVarHealthbarPoolSize.GetValueOnGameThread(), 0);
+
+	// The most relevant first: by significance, then the closest
+	Visible.Sort([](const FVisibleHealthbar& A, const FVisibleHealthbar& B)
+	{
+		const ESignificance SignificanceA = A.Character->GetSignificance();
+		const ESignificance SignificanceB = B.Character->GetSignificance();
+		return SignificanceA != SignificanceB ? SignificanceA < SignificanceB : A.Distance < B.Distance;
+	});
+	const auto Selected = Visible.Left(FMath::Min(PoolSize, Visible.Num()));
+
+	// Free the widgets of characters that dropped out, and any past a shrunk pool
+	for (int32 Index = 0; Index < PooledWidgets.Num(); ++Index)
+	{
+		const auto Bound = PooledCharacters[Index].Get();
+		const bool IsStillSelected = Index < PoolSize && Bound && Selected.ContainsByPredicate(
+			[Bound](const FVisibleHealthbar& Healthbar) { return Healthbar.Character == Bound; }
+		);
+		if (!IsStillSelected && (Bound || PooledWidgets[Index]->GetVisibility() != ESlateVisibility::Collapsed))
+		{
+			PooledCharacters[Index] = nullptr;
+			PooledWidgets[Index]->SetVisibility(ESlateVisibility::Collapsed);
+		}
+	}
+
+	int32 NumRebound = 0;
+	for (const auto& Healthbar : Selected)
+	{
+		int32 Index = PooledCharacters.IndexOfByKey(Healthbar.Character);
+		if (Index == INDEX_NONE)
+		{
+			Index = AcquirePooledWidget(PoolSize);
+			if (Index == INDEX_NONE)
+			{
+				break;
+			}
+
+			PooledCharacters[Index] = Healthbar.Character;
+			PooledWidgets[Index]->SetOwningCharacter(Healthbar.Character);
+			PooledWidgets[Index]->SetVisibility(ESlateVisibility::HitTestInvisible);
+			++NumRebound;
+		}
+
+		// ProjectWorldLocationToScreen returns viewport pixels, the widget's position is in DPI scaled units
+		const auto Widget = PooledWidgets[Index];
+		Widget->SetPositionInViewport(Healthbar.ScreenPosition, true);
+		Widget->SetRenderScale(FVector2D(Healthbar.Scale));
+	}
+
+	INC_DWORD_STAT_BY(STAT_Hera_HealthbarsDrawn, Selected.Num());
+	INC_DWORD_STAT_BY(STAT_Hera_HealthbarsRebound, NumRebound);
+}
+
+int32 UHealthbarSubsystem::AcquirePooledWidget(int32 PoolSize)
+{
+	for (int32 Index = 0; Index < FMath::Min(PooledWidgets.Num(), PoolSize); ++Index)
+	{
+		if (!PooledCharacters[Index].IsValid())
+		{
+			return Index;
+		}
+	}
+
+	const auto PlayerController = GetWorld()->GetFirstPlayerController();
+	if (PooledWidgets.Num() >= PoolSize || !PlayerController || !ResolvePooledWidgetClass())
+	{
+		return INDEX_NONE;
+	}
+
+	const auto Widget = CreateWidget<UHealthbarWidget>(PlayerController, PooledWidgetClass);
+	if (!Widget)
+	{
+		return INDEX_NONE;
+	}
+
+	Widget->AddToViewport(kOverlayZOrder);
+	Widget->SetAlignmentInViewport(FVector2D(0.5f, 1.0f));
+	PooledCharacters.Add(nullptr);
+	return PooledWidgets.Add(Widget);
+}
+
+bool UHealthbarSubsystem::ResolvePooledWidgetClass()
+{
+	if (PooledWidgetClass)
+	{
+		return true;
+	}
+
+	PooledWidgetClass = PooledWidgetSoftClass.Get();
+	if (PooledWidgetClass)
+	{
+		return true;
+	}
+
+	// The mode changed after the characters registered. The pool fills once the class is in.
+	if (!PooledWidgetSoftClass.IsPending() || !UAssetManager::IsValid())
+	{
+		return false;
+	}
+
+	if (!PooledWidgetClassHandle.IsValid())
+	{
+		PooledWidgetClassHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+			PooledWidgetSoftClass.ToSoftObjectPath()
+		);
+	}
+	else if (!PooledWidgetClassHandle->IsLoadingInProgress())
+	{
+		UE_LOG(
+			LogTemp, 
+			Error, 
+			TEXT("%s() Failed to load %s. If it was moved please update the reference."),
+			*FString(__FUNCTION__),
+			*PooledWidgetSoftClass.ToString()
+		);
+		PooledWidgetSoftClass.Reset();
+	}
+
+	return false;
+}
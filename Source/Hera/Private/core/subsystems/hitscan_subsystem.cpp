@@ -0,0 +1,202 @@
+// Copyright Final Fall Games. All Rights Reserved.
+
+#include "core/subsystems/hitscan_subsystem.h"
+#include "core/actors/base_character_actor.h"
+#include "core/gas/base_asc.h"
+#include "core/subsystems/lag_compensation_subsystem.h"
+#include "core/hera_collision.h"
+#include "core/hera_stats.h"
+
+#include "Components/CapsuleComponent.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("HitscanIssue"), STAT_Hera_HitscanIssue, STATGROUP_Hera);
+DECLARE_CYCLE_STAT(TEXT("HitscanResolve"), STAT_Hera_HitscanResolve, STATGROUP_Hera);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hitscan pellets/frame"), STAT_Hera_HitscanPellets, STATGROUP_Hera);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hitscan traces late"), STAT_Hera_HitscanTracesLate, STATGROUP_Hera);
+
+bool UHitscanSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UHitscanSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UHitscanSubsystem, STATGROUP_Tickables);
+}
+
+void UHitscanSubsystem::Deinitialize()
+{
+	QueuedShots.Reset();
+	TracedShots.Reset();
+	Pellets.Reset();
+
+	Super::Deinitialize();
+}
+
+void UHitscanSubsystem::QueueShot(const FHitscanShot& Shot)
+{
+	if (Shot.PelletCount > 0 && Shot.Range > 0.0f)
+	{
+		QueuedShots.Add(Shot);
+	}
+}
+
+void UHitscanSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (Pellets.Num() > 0)
+	{
+		ResolvePellets();
+	}
+
+	if (QueuedShots.Num() > 0)
+	{
+		IssuePellets();
+	}
+}
+
+void UHitscanSubsystem::IssuePellets()
+{
+	HERA_SCOPE_CYCLE_COUNTER(HitscanIssue);
+
+	const auto World = GetWorld();
+	TracedShots = MoveTemp(QueuedShots);
+	QueuedShots.Reset();
+	Pellets.Reset();
+
+	for (int32 ShotIndex = 0; ShotIndex < TracedShots.Num(); ++ShotIndex)
+	{
+		const auto& Shot = TracedShots[ShotIndex];
+		const FVector Direction = Shot.Direction.GetSafeNormal();
+		const float SpreadRadians = FMath::DegreesToRadians(FMath::Max(Shot.SpreadDegrees, 0.0f));
+		FRandomStream Random(Shot.Seed);
+
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(HeraHitscan), false, Shot.Instigator.Get());
+
+		for (int32 PelletIndex = 0; PelletIndex < Shot.PelletCount; ++PelletIndex)
+		{
+			const FVector PelletDirection = SpreadRadians > 0.0f ? Random.VRandCone(Direction, SpreadRadians) : Direction;
+
+			FHitscanPellet& Pellet = Pellets.AddDefaulted_GetRef();
+			Pellet.Start = Shot.Origin;
+			Pellet.End = Shot.Origin + PelletDirection * Shot.Range;
+			Pellet.ShotIndex = ShotIndex;
+			Pellet.Handle = World->AsyncLineTraceByProfile(
+				EAsyncTraceType::Single,
+				Pellet.Start,
+				Pellet.End,
+				HeraCollision::kProjectileProfile,
+				QueryParams
+			);
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_Hera_HitscanPellets, Pellets.Num());
+}
+
+void UHitscanSubsystem::ResolvePellets()
+{
+	HERA_SCOPE_CYCLE_COUNTER(HitscanResolve);
+
+	const auto World = GetWorld();
+	const bool HasAuthority = World->GetNetMode() != NM_Client;
+
+	// Pellets are grouped by shot in queue order, so walking them in order resolves the shots in order too
+	FTraceDatum Datum;
+	for (const auto& Pellet : Pellets)
+	{
+		const auto& Shot = TracedShots[Pellet.ShotIndex];
+
+		FHitResult Hit;
+		bool DidHit = false;
+		if (World->QueryTraceData(Pellet.Handle, Datum))
+		{
+			DidHit = Datum.OutHits.Num() > 0 && Datum.OutHits[0].bBlockingHit;
+			if (DidHit)
+			{
+				Hit = Datum.OutHits[0];
+			}
+		}
+		else
+		{
+			// Not back in time. Trace it now rather than lose the pellet.
+			INC_DWORD_STAT(STAT_Hera_HitscanTracesLate);
+			FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(HeraHitscan), false, Shot.Instigator.Get());
+			DidHit = World->LineTraceSingleByProfile(Hit, Pellet.Start, Pellet.End, HeraCollision::kProjectileProfile, QueryParams);
+		}
+
+		if (HasAuthority && Shot.ShooterTime >= 0.0f)
+		{
+			DidHit = RewindPellet(Shot, Pellet, Hit, DidHit);
+		}
+
+		if (!DidHit)
+		{
+			continue;
+		}
+
+		const auto OtherComp = Hit.GetComponent();
+		if (OtherComp && OtherComp->IsSimulatingPhysics())
+		{
+			const FVector Direction = (Pellet.End - Pellet.Start).GetSafeNormal();
+			OtherComp->AddImpulseAtLocation(Direction * Shot.ImpulseStrength * OtherComp->GetMass(), Hit.ImpactPoint);
+		}
+
+		if (HasAuthority && Hit.GetActor())
+		{
+			UAbilitySystemComponentBase::ApplyHitDamage(
+				Hit.GetActor(),
+				Shot.Instigator.Get(),
+				Shot.EffectSpecHandle,
+				Shot.DirectDamage
+			);
+		}
+	}
+
+	Pellets.Reset();
+	TracedShots.Reset();
+}
+
+bool UHitscanSubsystem::RewindPellet(const FHitscanShot& Shot, const FHitscanPellet& Pellet, FHitResult& InOutHit, bool DidHit) const
+{
+	const auto World = GetWorld();
+	const auto LagCompensation = World->GetSubsystem<ULagCompensationSubsystem>();
+	if (!LagCompensation || !ULagCompensationSubsystem::IsEnabled())
+	{
+		return DidHit;
+	}
+
+	// A character where it is now doesn't stop the pellet, only where it was does. Find what else would.
+	if (DidHit && LagCompensation->IsRecorded(InOutHit.GetActor()))
+	{
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(HeraHitscan), false, Shot.Instigator.Get());
+		FCollisionResponseParams ResponseParams;
+		ResponseParams.CollisionResponse.SetResponse(ECC_Pawn, ECR_Ignore);
+		DidHit = World->LineTraceSingleByChannel(
+			InOutHit,
+			Pellet.Start,
+			Pellet.End,
+			HeraCollision::GetProjectileChannel(),
+			QueryParams,
+			ResponseParams
+		);
+	}
+
+	const FVector StopAt = DidHit ? InOutHit.ImpactPoint : Pellet.End;
+	FLagCompensationHit Rewound;
+	if (!LagCompensation->RewindTrace(Shot.ShooterTime, Pellet.Start, StopAt, 0.0f, Shot.Instigator.Get(), Rewound))
+	{
+		return DidHit;
+	}
+
+	const FVector Direction = (Pellet.End - Pellet.Start).GetSafeNormal();
+	InOutHit = FHitResult(Rewound.Character, Rewound.Character->GetCapsuleComponent(), Rewound.Location, -Direction);
+	if (Rewound.HitZone != INDEX_NONE)
+	{
+		InOutHit.BoneName = Rewound.Character->HitZones[Rewound.HitZone].Bone;
+	}
+	return true;
+}
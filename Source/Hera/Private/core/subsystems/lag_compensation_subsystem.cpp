@@ -0,0 +1,334 @@
+// Copyright Final Fall Games. All Rights Reserved.
+
+#include "core/subsystems/lag_compensation_subsystem.h"
+#include "core/actors/base_character_actor.h"
+#include "core/hera_stats.h"
+
+#include "Components/CapsuleComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("LagCompensationRecord"), STAT_Hera_LagCompensationRecord, STATGROUP_Hera);
+DECLARE_CYCLE_STAT(TEXT("LagCompensationRewind"), STAT_Hera_LagCompensationRewind, STATGROUP_Hera);
+
+static TAutoConsoleVariable<int32> CVarLagCompensation(
+	TEXT("Hera.LagCompensation"),
+	1,
+	TEXT("Check hits against where characters were when the shooter fired.\n")
+	TEXT("0: Off, hits are checked against where characters are now\n")
+	TEXT("1: On (default)"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<int32> CVarLagCompensationMaxRewindMs(
+	TEXT("Hera.LagCompensation.MaxRewindMs"),
+	250,
+	TEXT("Furthest back in ms a shot is rewound. Older shots are checked at this limit."),
+	ECVF_Default
+);
+
+//---------------------------------------------------------------------------------------------------------------------
+/// MARK: - FLagCompensationHistory
+//---------------------------------------------------------------------------------------------------------------------
+
+int32 FLagCompensationHistory::AddSlot()
+{
+	Radii.AddZeroed();
+	NumHitZones.AddZeroed();
+	HitZoneRadii.AddZeroed(kLagCompensationMaxHitZones);
+	Locations.AddZeroed(kLagCompensationFrames);
+	HalfHeights.AddZeroed(kLagCompensationFrames);
+	HitZoneCenters.AddZeroed(kLagCompensationFrames * kLagCompensationMaxHitZones);
+	return Characters.AddDefaulted();
+}
+
+void FLagCompensationHistory::Reset()
+{
+	FrameTimes.Reset();
+	NewestFrame = INDEX_NONE;
+	NumFrames = 0;
+	Characters.Reset();
+	Radii.Reset();
+	NumHitZones.Reset();
+	HitZoneRadii.Reset();
+	Locations.Reset();
+	HalfHeights.Reset();
+	HitZoneCenters.Reset();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// MARK: - ULagCompensationSubsystem
+//---------------------------------------------------------------------------------------------------------------------
+
+bool ULagCompensationSubsystem::IsEnabled()
+{
+	return CVarLagCompensation.GetValueOnGameThread() > 0;
+}
+
+bool ULagCompensationSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId ULagCompensationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(ULagCompensationSubsystem, STATGROUP_Tickables);
+}
+
+void ULagCompensationSubsystem::Deinitialize()
+{
+	History.Reset();
+	SlotsByCharacter.Reset();
+	FreeSlots.Reset();
+
+	Super::Deinitialize();
+}
+
+void ULagCompensationSubsystem::Register(ACharacterBase* Character)
+{
+	const auto World = GetWorld();
+	if (!Character || !World || World->GetNetMode() == NM_Client || SlotsByCharacter.Contains(Character))
+	{
+		return;
+	}
+
+	if (History.FrameTimes.Num() == 0)
+	{
+		History.FrameTimes.SetNumZeroed(kLagCompensationFrames);
+	}
+
+	const int32 Slot = FreeSlots.Num() > 0 ? FreeSlots.Pop(false) : History.AddSlot();
+	SlotsByCharacter.Add(Character, Slot);
+	History.Characters[Slot] = Character;
+	History.Radii[Slot] = Character->GetCapsuleComponent()->GetScaledCapsuleRadius();
+
+	const int32 NumHitZones = FMath::Min(Character->HitZones.Num(), kLagCompensationMaxHitZones);
+	History.NumHitZones[Slot] = static_cast<uint8>(NumHitZones);
+	for (int32 Zone = 0; Zone < NumHitZones; ++Zone)
+	{
+		History.HitZoneRadii[Slot * kLagCompensationMaxHitZones + Zone] = Character->HitZones[Zone].Radius;
+	}
+
+	// No history yet, so the character was where it is now as far back as anyone can ask
+	for (int32 Frame = 0; Frame < kLagCompensationFrames; ++Frame)
+	{
+		WritePose(Slot, Frame, Character);
+	}
+}
+
+void ULagCompensationSubsystem::Unregister(ACharacterBase* Character)
+{
+	int32 Slot = INDEX_NONE;
+	if (SlotsByCharacter.RemoveAndCopyValue(Character, Slot))
+	{
+		History.Characters[Slot].Reset();
+		FreeSlots.Add(Slot);
+	}
+}
+
+bool ULagCompensationSubsystem::IsRecorded(const AActor* Actor) const
+{
+	const auto Character = Cast<ACharacterBase>(Actor);
+	return Character && SlotsByCharacter.Contains(Character);
+}
+
+void ULagCompensationSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (SlotsByCharacter.Num() > 0)
+	{
+		Record(GetWorld()->GetTimeSeconds());
+	}
+}
+
+void ULagCompensationSubsystem::Record(float ServerTime)
+{
+	HERA_SCOPE_CYCLE_COUNTER(LagCompensationRecord);
+
+	if (History.FrameTimes.Num() == 0)
+	{
+		return;
+	}
+
+	History.NewestFrame = (History.NewestFrame + 1) % kLagCompensationFrames;
+	History.NumFrames = FMath::Min(History.NumFrames + 1, kLagCompensationFrames);
+	History.FrameTimes[History.NewestFrame] = ServerTime;
+
+	for (int32 Slot = 0; Slot < History.NumSlots(); ++Slot)
+	{
+		if (const auto Character = History.Characters[Slot].Get())
+		{
+			WritePose(Slot, History.NewestFrame, Character);
+		}
+	}
+}
+
+void ULagCompensationSubsystem::WritePose(int32 Slot, int32 Frame, const ACharacterBase* Character)
+{
+	const int32 RecordIndex = Slot * kLagCompensationFrames + Frame;
+	const auto Capsule = Character->GetCapsuleComponent();
+	History.Locations[RecordIndex] = FVector3f(Capsule->GetComponentLocation());
+	History.HalfHeights[RecordIndex] = Capsule->GetScaledCapsuleHalfHeight();
+
+	const auto Mesh = Character->GetMesh();
+	const int32 NumHitZones = History.NumHitZones[Slot];
+	for (int32 Zone = 0; Zone < NumHitZones; ++Zone)
+	{
+		const FName Bone = Character->HitZones[Zone].Bone;
+		const FVector Center = Mesh ? Mesh->GetSocketLocation(Bone) : Capsule->GetComponentLocation();
+		History.HitZoneCenters[RecordIndex * kLagCompensationMaxHitZones + Zone] = FVector3f(Center);
+	}
+}
+
+bool ULagCompensationSubsystem::FindFrames(float ServerTime, int32& OutOlder, int32& OutNewer, float& OutAlpha) const
+{
+	if (History.NumFrames == 0)
+	{
+		return false;
+	}
+
+	const float NewestTime = History.FrameTimes[History.NewestFrame];
+	const float MaxRewind = CVarLagCompensationMaxRewindMs.GetValueOnGameThread() / 1000.0f;
+	const float Time = FMath::Clamp(ServerTime, NewestTime - MaxRewind, NewestTime);
+
+	// Walk back from the newest frame to the first one at or before Time
+	OutNewer = History.NewestFrame;
+	for (int32 Age = 0; Age < History.NumFrames; ++Age)
+	{
+		const int32 Frame = (History.NewestFrame - Age + kLagCompensationFrames) % kLagCompensationFrames;
+		const float FrameTime = History.FrameTimes[Frame];
+		if (FrameTime <= Time)
+		{
+			const float NewerTime = History.FrameTimes[OutNewer];
+			OutOlder = Frame;
+			OutAlpha = NewerTime > FrameTime ? (Time - FrameTime) / (NewerTime - FrameTime) : 0.0f;
+			return true;
+		}
+
+		OutNewer = Frame;
+	}
+
+	// Older than anything recorded, so use the oldest frame
+	OutOlder = OutNewer;
+	OutAlpha = 0.0f;
+	return true;
+}
+
+bool ULagCompensationSubsystem::GetRewoundLocation(const ACharacterBase* Character, float ServerTime, FVector& OutLocation) const
+{
+	const int32* Slot = SlotsByCharacter.Find(Character);
+	int32 Older, Newer;
+	float Alpha;
+	if (!Slot || !FindFrames(ServerTime, Older, Newer, Alpha))
+	{
+		return false;
+	}
+
+	const int32 First = *Slot * kLagCompensationFrames;
+	OutLocation = FVector(FMath::Lerp(History.Locations[First + Older], History.Locations[First + Newer], Alpha));
+	return true;
+}
+
+bool ULagCompensationSubsystem::RewindTrace(
+	float ServerTime,
+	const FVector& Start,
+	const FVector& End,
+	float Radius,
+	const AActor* IgnoreActor,
+	FLagCompensationHit& OutHit
+) const
+{
+	HERA_SCOPE_CYCLE_COUNTER(LagCompensationRewind);
+
+	int32 Older, Newer;
+	float Alpha;
+	if (!FindFrames(ServerTime, Older, Newer, Alpha))
+	{
+		return false;
+	}
+
+	bool DidHit = false;
+	OutHit.Distance = TNumericLimits<float>::Max();
+
+	for (int32 Slot = 0; Slot < History.NumSlots(); ++Slot)
+	{
+		const auto Character = History.Characters[Slot].Get();
+		if (!Character || Character == IgnoreActor)
+		{
+			continue;
+		}
+
+		const int32 OlderRecord = Slot * kLagCompensationFrames + Older;
+		const int32 NewerRecord = Slot * kLagCompensationFrames + Newer;
+		const FVector Location(FMath::Lerp(History.Locations[OlderRecord], History.Locations[NewerRecord], Alpha));
+		const float HalfHeight = FMath::Lerp(History.HalfHeights[OlderRecord], History.HalfHeights[NewerRecord], Alpha);
+		const float CapsuleRadius = History.Radii[Slot];
+
+		// Hit zones sit inside the capsule, so nothing of the character is further from its center than the half
+		// height plus the largest zone. Most characters stop here.
+		const int32 NumHitZones = History.NumHitZones[Slot];
+		float Reach = HalfHeight + Radius;
+		for (int32 Zone = 0; Zone < NumHitZones; ++Zone)
+		{
+			Reach = FMath::Max(Reach, HalfHeight + Radius + History.HitZoneRadii[Slot * kLagCompensationMaxHitZones + Zone]);
+		}
+
+		if (FMath::PointDistToSegmentSquared(Location, Start, End) > FMath::Square(Reach))
+		{
+			continue;
+		}
+
+		FLagCompensationHit Hit;
+		bool DidHitCharacter = false;
+
+		// Hit zones first, they win over the body they're inside of
+		float ClosestZoneDistance = TNumericLimits<float>::Max();
+		for (int32 Zone = 0; Zone < NumHitZones; ++Zone)
+		{
+			const FVector Center(FMath::Lerp(
+				History.HitZoneCenters[OlderRecord * kLagCompensationMaxHitZones + Zone],
+				History.HitZoneCenters[NewerRecord * kLagCompensationMaxHitZones + Zone],
+				Alpha
+			));
+			const FVector Closest = FMath::ClosestPointOnSegment(Center, Start, End);
+			const float ZoneDistance = FVector::Dist(Closest, Center);
+			if (ZoneDistance <= History.HitZoneRadii[Slot * kLagCompensationMaxHitZones + Zone] + Radius && ZoneDistance < ClosestZoneDistance)
+			{
+				ClosestZoneDistance = ZoneDistance;
+				Hit.Location = Closest;
+				Hit.HitZone = Zone;
+				DidHitCharacter = true;
+			}
+		}
+
+		if (!DidHitCharacter)
+		{
+			// The capsule is a segment along Z with the capsule radius around it
+			const FVector Axis(0.0f, 0.0f, FMath::Max(HalfHeight - CapsuleRadius, 0.0f));
+			FVector OnTrace, OnCapsule;
+			FMath::SegmentDistToSegmentSafe(Start, End, Location + Axis, Location - Axis, OnTrace, OnCapsule);
+			if (FVector::DistSquared(OnTrace, OnCapsule) <= FMath::Square(CapsuleRadius + Radius))
+			{
+				Hit.Location = OnTrace;
+				DidHitCharacter = true;
+			}
+		}
+
+		if (!DidHitCharacter)
+		{
+			continue;
+		}
+
+		Hit.Character = Character;
+		Hit.Distance = FVector::Dist(Start, Hit.Location);
+		if (Hit.Distance < OutHit.Distance)
+		{
+			OutHit = Hit;
+			DidHit = true;
+		}
+	}
+
+	return DidHit;
+}
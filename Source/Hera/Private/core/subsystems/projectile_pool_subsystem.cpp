@@ -0,0 +1,201 @@
+// Copyright Final Fall Games. All Rights Reserved.
+
+#include "core/subsystems/projectile_pool_subsystem.h"
+#include "core/actors/projectile_actor.h"
+
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarProjectilePool(
+	TEXT("Hera.Projectile.Pool"),
+	1,
+	TEXT("Reuse projectiles instead of spawning and destroying one per shot.\n")
+	TEXT("0: Spawn and destroy\n")
+	TEXT("1: Pool (default)"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<int32> CVarProjectilePoolPrewarm(
+	TEXT("Hera.Projectile.PoolPrewarm"),
+	32,
+	TEXT("Projectiles spawned ahead of time when a weapon is equipped."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<int32> CVarProjectilePoolMax(
+	TEXT("Hera.Projectile.PoolMax"),
+	256,
+	TEXT("Most free projectiles kept per class. Projectiles released past it are destroyed."),
+	ECVF_Default
+);
+
+bool UProjectilePoolSubsystem::IsPoolingEnabled()
+{
+	return CVarProjectilePool.GetValueOnGameThread() > 0;
+}
+
+bool UProjectilePoolSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UProjectilePoolSubsystem::Deinitialize()
+{
+	// The free projectiles are destroyed with the world
+	Pools.Reset();
+
+	Super::Deinitialize();
+}
+
+/// A reused projectile still has the damage of its last shot, so the class's own Damage is set back too.
+static void SetDirectDamage(AProjectileBase* Projectile, float DirectDamage)
+{
+	if (auto HeraProjectile = Cast<AHeraProjectile>(Projectile))
+	{
+		HeraProjectile->Damage = DirectDamage >= 0.0f 
+			? DirectDamage 
+			: HeraProjectile->GetClass()->GetDefaultObject<AHeraProjectile>()->Damage;
+	}
+}
+
+AProjectileBase* UProjectilePoolSubsystem::Acquire(
+	TSubclassOf<AProjectileBase> ProjectileClass,
+	const FTransform& SpawnTransform,
+	AActor* Owner,
+	APawn* Instigator,
+	const FGameplayEffectSpecHandle& EffectSpecHandle,
+	float DirectDamage
+)
+{
+	const auto World = GetWorld();
+	if (!ProjectileClass || !World)
+	{
+		return nullptr;
+	}
+
+	if (!IsPoolingEnabled())
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.Owner = Owner;
+		SpawnParams.Instigator = Instigator;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		SpawnParams.bDeferConstruction = true;
+
+		auto Projectile = World->SpawnActor<AProjectileBase>(ProjectileClass, SpawnTransform, SpawnParams);
+		if (Projectile)
+		{
+			Projectile->EffectSpecHandle = EffectSpecHandle;
+			SetDirectDamage(Projectile, DirectDamage);
+			Projectile->FinishSpawning(SpawnTransform);
+		}
+		return Projectile;
+	}
+
+	AProjectileBase* Projectile = nullptr;
+	if (auto Pool = Pools.Find(ProjectileClass.Get()))
+	{
+		while (!Projectile && Pool->Free.Num() > 0)
+		{
+			// Skip anything destroyed behind our back, e.g. by a level streaming out
+			Projectile = Pool->Free.Pop(false);
+			if (!IsValid(Projectile))
+			{
+				Projectile = nullptr;
+			}
+		}
+	}
+
+	if (!Projectile)
+	{
+		Projectile = SpawnPooled(ProjectileClass, SpawnTransform);
+		if (!Projectile)
+		{
+			return nullptr;
+		}
+	}
+
+	Projectile->SetOwner(Owner);
+	Projectile->SetInstigator(Instigator);
+	Projectile->EffectSpecHandle = EffectSpecHandle;
+	SetDirectDamage(Projectile, DirectDamage);
+	Projectile->Launch(SpawnTransform.GetLocation(), SpawnTransform.Rotator());
+	return Projectile;
+}
+
+void UProjectilePoolSubsystem::Release(AProjectileBase* Projectile)
+{
+	if (!IsValid(Projectile) || !Projectile->IsInPlay())
+	{
+		return;
+	}
+
+	auto& Pool = Pools.FindOrAdd(Projectile->GetClass());
+	if (!IsPoolingEnabled() || Pool.Free.Num() >= CVarProjectilePoolMax.GetValueOnGameThread())
+	{
+		Projectile->Destroy();
+		return;
+	}
+
+	Projectile->Retire();
+	Projectile->SetOwner(nullptr);
+	Projectile->SetInstigator(nullptr);
+	Pool.Free.Add(Projectile);
+}
+
+void UProjectilePoolSubsystem::Prewarm(TSubclassOf<AProjectileBase> ProjectileClass, int32 Count)
+{
+	if (!ProjectileClass || !IsPoolingEnabled())
+	{
+		return;
+	}
+
+	auto& Pool = Pools.FindOrAdd(ProjectileClass.Get());
+	const int32 TargetCount = FMath::Min<int32>(Count, CVarProjectilePoolMax.GetValueOnGameThread());
+	while (Pool.Free.Num() < TargetCount)
+	{
+		auto Projectile = SpawnPooled(ProjectileClass, FTransform::Identity);
+		if (!Projectile)
+		{
+			break;
+		}
+
+		Pool.Free.Add(Projectile);
+	}
+}
+
+void UProjectilePoolSubsystem::Prewarm(TSubclassOf<AProjectileBase> ProjectileClass)
+{
+	Prewarm(ProjectileClass, CVarProjectilePoolPrewarm.GetValueOnGameThread());
+}
+
+int32 UProjectilePoolSubsystem::GetNumFree(TSubclassOf<AProjectileBase> ProjectileClass) const
+{
+	const auto Pool = Pools.Find(ProjectileClass.Get());
+	return Pool ? Pool->Free.Num() : 0;
+}
+
+AProjectileBase* UProjectilePoolSubsystem::SpawnPooled(UClass* ProjectileClass, const FTransform& SpawnTransform)
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParams.bDeferConstruction = true;
+
+	auto Projectile = GetWorld()->SpawnActor<AProjectileBase>(ProjectileClass, SpawnTransform, SpawnParams);
+	if (!Projectile)
+	{
+		return nullptr;
+	}
+
+	// Set before BeginPlay so the projectile knows it's pooled and stays out of play until launched.
+	// DORM_Initial only holds back actors placed in the map. A spawned one has to start fully dormant, and
+	// AProjectileBase::Launch wakes it up.
+	Projectile->Pool = this;
+	Projectile->PoolState.IsPooled = true;
+	Projectile->NetDormancy = DORM_DormantAll;
+	Projectile->FinishSpawning(SpawnTransform);
+
+	// The lifespan timer and collision from construction belong to a launch, not to the pool
+	Projectile->SetLifeSpan(0.0f);
+	Projectile->LeavePlay();
+	return Projectile;
+}
@@ -0,0 +1,624 @@
+// Copyright Final Fall Games. All Rights Reserved.
+
+#include "core/subsystems/projectile_sim_subsystem.h"
+#include "core/actors/projectile_actor.h"
+#include "core/gas/base_asc.h"
+#include "core/hera_collision.h"
+#include "core/hera_stats.h"
+
+#include "Components/SphereComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "Async/ParallelFor.h"
+
+DECLARE_CYCLE_STAT(TEXT("ProjectileSim"), STAT_Hera_ProjectileSim, STATGROUP_Hera);
+DECLARE_CYCLE_STAT(TEXT("ProjectileSimIntegrate"), STAT_Hera_ProjectileSimIntegrate, STATGROUP_Hera);
+DECLARE_CYCLE_STAT(TEXT("ProjectileSimSweep"), STAT_Hera_ProjectileSimSweep, STATGROUP_Hera);
+DECLARE_CYCLE_STAT(TEXT("ProjectileSimResolve"), STAT_Hera_ProjectileSimResolve, STATGROUP_Hera);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Projectile sweeps late"), STAT_Hera_ProjectileSweepsLate, STATGROUP_Hera);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Projectile spawn events"), STAT_Hera_ProjectileSpawnEvents, STATGROUP_Hera);
+
+static TAutoConsoleVariable<int32> CVarBatchedProjectiles(
+	TEXT("Hera.Projectile.Batched"),
+	1,
+	TEXT("Fly projectile classes with UseBatchedSimulation in UProjectileSimSubsystem.\n")
+	TEXT("0: Every projectile flies as an actor\n")
+	TEXT("1: Batched where the class opts in (default)"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<int32> CVarProjectileSweepMode(
+	TEXT("Hera.Projectile.SweepMode"),
+	0,
+	TEXT("How batched projectiles sweep against the world each frame.\n")
+	TEXT("0: One after the other on the game thread (default)\n")
+	TEXT("1: In batches on worker threads with ParallelFor\n")
+	TEXT("2: As async scene queries, resolved at the start of the next tick"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<int32> CVarProjectileSpawnEvents(
+	TEXT("Hera.Projectile.SpawnEvents"),
+	1,
+	TEXT("How a networked server shows batched projectiles to clients.\n")
+	TEXT("0: Fly them as replicated actors\n")
+	TEXT("1: Send a spawn event and let clients simulate them (default)"),
+	ECVF_Default
+);
+
+/// Projectiles swept per ParallelFor task.
+static constexpr int32 kProjectileSweepBatchSize = 64;
+
+//---------------------------------------------------------------------------------------------------------------------
+/// MARK: - FProjectileLaunchParams
+//---------------------------------------------------------------------------------------------------------------------
+
+FProjectileLaunchParams FProjectileLaunchParams::FromClass(
+	TSubclassOf<AProjectileBase> ProjectileClass,
+	const FVector& Origin,
+	const FRotator& Direction
+)
+{
+	FProjectileLaunchParams Params;
+	Params.Origin = Origin;
+	Params.VisualClass = ProjectileClass;
+
+	const auto Projectile = ProjectileClass ? ProjectileClass->GetDefaultObject<AProjectileBase>() : nullptr;
+	if (!Projectile)
+	{
+		return Params;
+	}
+
+	Params.LifeSpan = Projectile->InitialLifeSpan > 0.0f ? Projectile->InitialLifeSpan : Params.LifeSpan;
+
+	if (const auto Movement = Projectile->ProjectileMovement)
+	{
+		Params.Velocity = Direction.Vector() * Movement->InitialSpeed;
+		Params.GravityScale = Movement->ProjectileGravityScale;
+	}
+
+	if (const auto Sphere = Cast<USphereComponent>(Projectile->GetRootComponent()))
+	{
+		Params.Radius = Sphere->GetUnscaledSphereRadius();
+	}
+
+	return Params;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// MARK: - FProjectileSpawnEvent
+//---------------------------------------------------------------------------------------------------------------------
+
+FVector FProjectileSpawnEvent::GetVelocity() const
+{
+	const FRotator Direction(
+		FRotator::DecompressAxisFromShort(Pitch),
+		FRotator::DecompressAxisFromShort(Yaw),
+		0.0f
+	);
+	return Direction.Vector() * Speed;
+}
+
+bool FProjectileSpawnEvent::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	UObject* Class = ProjectileClass.Get();
+	bOutSuccess = Map->SerializeObject(Ar, UClass::StaticClass(), Class);
+	bOutSuccess &= SerializePackedVector<10, 24>(Origin, Ar);
+
+	Ar << Yaw;
+	Ar << Pitch;
+	Ar.SerializeIntPacked(Speed);
+	Ar << ServerTime;
+	Ar << Seed;
+
+	if (Ar.IsLoading())
+	{
+		ProjectileClass = Cast<UClass>(Class);
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// MARK: - FProjectileSimState
+//---------------------------------------------------------------------------------------------------------------------
+
+int32 FProjectileSimState::Add(uint32 Id, const FProjectileLaunchParams& Params)
+{
+	Positions.Add(Params.Origin);
+	Velocities.Add(Params.Velocity);
+	Radii.Add(Params.Radius);
+	GravityScales.Add(Params.GravityScale);
+	TimesLeft.Add(Params.LifeSpan);
+
+	FProjectileSimPayload& Payload = Payloads.AddDefaulted_GetRef();
+	Payload.Instigator = Params.Instigator;
+	Payload.EffectSpecHandle = Params.EffectSpecHandle;
+	Payload.DirectDamage = Params.DirectDamage;
+
+	return Ids.Add(Id);
+}
+
+void FProjectileSimState::RemoveAtSwap(int32 Index)
+{
+	Ids.RemoveAtSwap(Index, 1, false);
+	Positions.RemoveAtSwap(Index, 1, false);
+	Velocities.RemoveAtSwap(Index, 1, false);
+	Radii.RemoveAtSwap(Index, 1, false);
+	GravityScales.RemoveAtSwap(Index, 1, false);
+	TimesLeft.RemoveAtSwap(Index, 1, false);
+	Payloads.RemoveAtSwap(Index, 1, false);
+}
+
+void FProjectileSimState::Reset()
+{
+	Ids.Reset();
+	Positions.Reset();
+	Velocities.Reset();
+	Radii.Reset();
+	GravityScales.Reset();
+	TimesLeft.Reset();
+	Payloads.Reset();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// MARK: - UProjectileSimSubsystem
+//---------------------------------------------------------------------------------------------------------------------
+
+bool UProjectileSimSubsystem::ShouldSimulate(TSubclassOf<AProjectileBase> ProjectileClass, const UWorld* World)
+{
+	const auto Projectile = ProjectileClass ? ProjectileClass->GetDefaultObject<AProjectileBase>() : nullptr;
+	if (!Projectile || !Projectile->UseBatchedSimulation || CVarBatchedProjectiles.GetValueOnGameThread() <= 0)
+	{
+		return false;
+	}
+
+	// A networked server without spawn events has no other way to show the projectile to its clients
+	const bool IsNetworkedServer = World && (World->GetNetMode() == NM_ListenServer || World->GetNetMode() == NM_DedicatedServer);
+	return !IsNetworkedServer || ShouldSendSpawnEvents(World);
+}
+
+bool UProjectileSimSubsystem::ShouldSendSpawnEvents(const UWorld* World)
+{
+	const bool IsNetworkedServer = World && (World->GetNetMode() == NM_ListenServer || World->GetNetMode() == NM_DedicatedServer);
+	return IsNetworkedServer && CVarProjectileSpawnEvents.GetValueOnGameThread() > 0;
+}
+
+bool UProjectileSimSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UProjectileSimSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UProjectileSimSubsystem, STATGROUP_Tickables);
+}
+
+void UProjectileSimSubsystem::Deinitialize()
+{
+	State.Reset();
+	PendingSweeps.Reset();
+	Impacts.Reset();
+	Finished.Reset();
+	FreeVisuals.Reset();
+	SET_DWORD_STAT(STAT_Hera_ProjectilesSimulated, 0);
+
+	Super::Deinitialize();
+}
+
+uint32 UProjectileSimSubsystem::Launch(const FProjectileLaunchParams& Params, float FastForwardSeconds)
+{
+	const auto World = GetWorld();
+
+	FProjectileLaunchParams LaunchParams = Params;
+	FHitResult Hit;
+	if (FastForwardSeconds > 0.0f && !FastForward(LaunchParams, FastForwardSeconds, Hit))
+	{
+		// A client's copy hit what the server's did, which dealt with it. The server's own projectile hit before
+		// this frame caught up with it, so it deals with the hit now.
+		const bool HasAuthority = World->GetNetMode() != NM_Client;
+		if (HasAuthority && Hit.bBlockingHit)
+		{
+			FProjectileImpact Impact;
+			Impact.Hit = Hit;
+			Impact.Velocity = LaunchParams.Velocity;
+			Impact.Payload.Instigator = LaunchParams.Instigator;
+			Impact.Payload.EffectSpecHandle = LaunchParams.EffectSpecHandle;
+			Impact.Payload.DirectDamage = LaunchParams.DirectDamage;
+			ApplyImpact(Impact, HasAuthority);
+		}
+		return 0;
+	}
+
+	const uint32 Id = NextId++;
+	const int32 Index = State.Add(Id, LaunchParams);
+
+	// Only pay for an actor where someone can see it
+	if (LaunchParams.VisualClass && World && World->GetNetMode() != NM_DedicatedServer)
+	{
+		State.Payloads[Index].Visual = AcquireVisual(LaunchParams.VisualClass, LaunchParams.Origin, LaunchParams.Velocity.Rotation());
+	}
+
+	return Id;
+}
+
+uint32 UProjectileSimSubsystem::LaunchFromSpawnEvent(const FProjectileSpawnEvent& Event, AActor* Instigator)
+{
+	if (!Event.ProjectileClass)
+	{
+		return 0;
+	}
+
+	const FVector Velocity = Event.GetVelocity();
+	auto Params = FProjectileLaunchParams::FromClass(Event.ProjectileClass, Event.Origin, Velocity.Rotation());
+	Params.Velocity = Velocity;
+	Params.Instigator = Instigator;
+
+	// No damage on the client copy. The server's copy applies it, so the payload stays empty.
+	const float Latency = FMath::Max(GetServerTime() - Event.ServerTime, 0.0f);
+	return Launch(Params, Latency);
+}
+
+FProjectileSpawnEvent UProjectileSimSubsystem::MakeSpawnEvent(
+	TSubclassOf<AProjectileBase> ProjectileClass,
+	const FProjectileLaunchParams& Params,
+	uint16 Seed,
+	float Age
+) const
+{
+	INC_DWORD_STAT(STAT_Hera_ProjectileSpawnEvents);
+
+	const FRotator Direction = Params.Velocity.Rotation();
+
+	FProjectileSpawnEvent Event;
+	Event.ProjectileClass = ProjectileClass;
+	Event.Origin = Params.Origin;
+	Event.Yaw = FRotator::CompressAxisToShort(Direction.Yaw);
+	Event.Pitch = FRotator::CompressAxisToShort(Direction.Pitch);
+	Event.Speed = FMath::RoundToInt(Params.Velocity.Size());
+	Event.ServerTime = GetServerTime() - Age;
+	Event.Seed = Seed;
+	return Event;
+}
+
+float UProjectileSimSubsystem::GetServerTime() const
+{
+	const auto World = GetWorld();
+	const auto GameState = World->GetGameState();
+	return GameState ? GameState->GetServerWorldTimeSeconds() : World->GetTimeSeconds();
+}
+
+bool UProjectileSimSubsystem::FastForward(FProjectileLaunchParams& Params, float Seconds, FHitResult& OutHit) const
+{
+	if (Seconds >= Params.LifeSpan)
+	{
+		return false;
+	}
+
+	const FVector Acceleration(0.0f, 0.0f, GetWorld()->GetGravityZ() * Params.GravityScale);
+	const FVector Start = Params.Origin;
+	const FVector End = Start + Params.Velocity * Seconds + Acceleration * (0.5f * Seconds * Seconds);
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(HeraProjectileSweep), false, Params.Instigator.Get());
+	const bool DidHit = GetWorld()->SweepSingleByProfile(
+		OutHit,
+		Start,
+		End,
+		FQuat::Identity,
+		HeraCollision::kProjectileProfile,
+		FCollisionShape::MakeSphere(Params.Radius),
+		QueryParams
+	);
+	if (DidHit)
+	{
+		// The sweep is a straight line, close enough to the arc over a frame or two
+		const float HitSeconds = Seconds * OutHit.Time;
+		Params.Origin = OutHit.Location;
+		Params.Velocity += Acceleration * HitSeconds;
+		return false;
+	}
+
+	Params.Origin = End;
+	Params.Velocity += Acceleration * Seconds;
+	Params.LifeSpan -= Seconds;
+	return true;
+}
+
+void UProjectileSimSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	SET_DWORD_STAT(STAT_Hera_ProjectilesSimulated, State.Num());
+	if (State.Num() == 0)
+	{
+		return;
+	}
+
+	HERA_SCOPE_CYCLE_COUNTER(ProjectileSim);
+
+	// Async sweeps from last tick are resolved before anything moves again, so a projectile that hit
+	// doesn't fly on. This also drains them if the mode changed since.
+	if (PendingSweeps.Num() > 0)
+	{
+		GatherImpacts(CollectAsyncSweeps());
+		Resolve();
+	}
+
+	Integrate(DeltaTime);
+
+	const int32 SweepMode = CVarProjectileSweepMode.GetValueOnGameThread();
+	if (SweepMode == 2)
+	{
+		IssueAsyncSweeps();
+	}
+	else
+	{
+		Sweep(SweepMode == 1);
+		GatherImpacts(State.Num());
+		Resolve();
+	}
+
+	UpdateVisuals();
+}
+
+void UProjectileSimSubsystem::Integrate(float DeltaTime)
+{
+	HERA_SCOPE_CYCLE_COUNTER(ProjectileSimIntegrate);
+
+	const int32 Count = State.Num();
+	PreviousPositions.Reset();
+	PreviousPositions.Append(State.Positions);
+
+	const FVector Gravity(0.0f, 0.0f, GetWorld()->GetGravityZ());
+	FVector* Positions = State.Positions.GetData();
+	FVector* Velocities = State.Velocities.GetData();
+	const float* GravityScales = State.GravityScales.GetData();
+	float* TimesLeft = State.TimesLeft.GetData();
+
+	// Same integration as UProjectileMovementComponent::ComputeMoveDelta
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		const FVector Acceleration = Gravity * GravityScales[Index];
+		Positions[Index] += Velocities[Index] * DeltaTime + Acceleration * (0.5f * DeltaTime * DeltaTime);
+		Velocities[Index] += Acceleration * DeltaTime;
+		TimesLeft[Index] -= DeltaTime;
+	}
+}
+
+bool UProjectileSimSubsystem::SweepProjectile(int32 Index, FHitResult& OutHit) const
+{
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(HeraProjectileSweep), false, State.Payloads[Index].Instigator.Get());
+
+	return GetWorld()->SweepSingleByProfile(
+		OutHit,
+		PreviousPositions[Index],
+		State.Positions[Index],
+		FQuat::Identity,
+		HeraCollision::kProjectileProfile,
+		FCollisionShape::MakeSphere(State.Radii[Index]),
+		QueryParams
+	);
+}
+
+void UProjectileSimSubsystem::Sweep(bool InParallel)
+{
+	HERA_SCOPE_CYCLE_COUNTER(ProjectileSimSweep);
+
+	const int32 Count = State.Num();
+	SweepHits.SetNum(Count, false);
+	SweepDidHit.SetNum(Count, false);
+
+	if (!InParallel)
+	{
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			SweepDidHit[Index] = SweepProjectile(Index, SweepHits[Index]);
+		}
+		return;
+	}
+
+	// Scene queries only read the physics scene, and every batch writes its own slice of the results
+	const int32 BatchCount = FMath::DivideAndRoundUp(Count, kProjectileSweepBatchSize);
+	ParallelFor(BatchCount, [this, Count](int32 Batch)
+	{
+		const int32 First = Batch * kProjectileSweepBatchSize;
+		const int32 Last = FMath::Min(First + kProjectileSweepBatchSize, Count);
+		for (int32 Index = First; Index < Last; ++Index)
+		{
+			SweepDidHit[Index] = SweepProjectile(Index, SweepHits[Index]);
+		}
+	});
+}
+
+void UProjectileSimSubsystem::IssueAsyncSweeps()
+{
+	HERA_SCOPE_CYCLE_COUNTER(ProjectileSimSweep);
+
+	const auto World = GetWorld();
+	const int32 Count = State.Num();
+	PendingSweeps.SetNum(Count, false);
+
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(HeraProjectileSweep), false, State.Payloads[Index].Instigator.Get());
+
+		PendingSweeps[Index].Key = World->AsyncSweepByProfile(
+			EAsyncTraceType::Single,
+			PreviousPositions[Index],
+			State.Positions[Index],
+			FQuat::Identity,
+			HeraCollision::kProjectileProfile,
+			FCollisionShape::MakeSphere(State.Radii[Index]),
+			QueryParams
+		);
+		PendingSweeps[Index].Value = State.Ids[Index];
+	}
+}
+
+int32 UProjectileSimSubsystem::CollectAsyncSweeps()
+{
+	HERA_SCOPE_CYCLE_COUNTER(ProjectileSimSweep);
+
+	const auto World = GetWorld();
+
+	// Only projectiles launched since the sweeps were issued are missing, and those were appended at the end
+	const int32 Count = FMath::Min(PendingSweeps.Num(), State.Num());
+	SweepHits.SetNum(Count, false);
+	SweepDidHit.SetNum(Count, false);
+
+	FTraceDatum Datum;
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		check(PendingSweeps[Index].Value == State.Ids[Index]);
+
+		if (World->QueryTraceData(PendingSweeps[Index].Key, Datum))
+		{
+			const bool DidHit = Datum.OutHits.Num() > 0 && Datum.OutHits[0].bBlockingHit;
+			SweepDidHit[Index] = DidHit;
+			if (DidHit)
+			{
+				SweepHits[Index] = Datum.OutHits[0];
+			}
+		}
+		else
+		{
+			// Not back in time. Keep the results deterministic by sweeping it now.
+			INC_DWORD_STAT(STAT_Hera_ProjectileSweepsLate);
+			++NumSweepsLate;
+			SweepDidHit[Index] = SweepProjectile(Index, SweepHits[Index]);
+		}
+	}
+
+	PendingSweeps.Reset();
+	return Count;
+}
+
+void UProjectileSimSubsystem::GatherImpacts(int32 Count)
+{
+	Impacts.Reset();
+	Finished.Reset();
+
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		if (SweepDidHit[Index])
+		{
+			FProjectileImpact& Impact = Impacts.AddDefaulted_GetRef();
+			Impact.Id = State.Ids[Index];
+			Impact.Hit = SweepHits[Index];
+			Impact.Velocity = State.Velocities[Index];
+			Impact.Payload = State.Payloads[Index];
+			Finished.Add(Index);
+		}
+		else if (State.TimesLeft[Index] <= 0.0f)
+		{
+			Finished.Add(Index);
+		}
+	}
+}
+
+void UProjectileSimSubsystem::Resolve()
+{
+	HERA_SCOPE_CYCLE_COUNTER(ProjectileSimResolve);
+
+	// Resolve in the order the projectiles were fired so the outcome doesn't depend on array order
+	Impacts.Sort([](const FProjectileImpact& A, const FProjectileImpact& B) { return A.Id < B.Id; });
+
+	const auto World = GetWorld();
+	const bool HasAuthority = World->GetNetMode() != NM_Client;
+
+	for (const auto& Impact : Impacts)
+	{
+		ApplyImpact(Impact, HasAuthority);
+	}
+
+	// Remove from the back so the swaps never move a projectile that's still waiting to be removed
+	Finished.Sort(TGreater<int32>());
+	for (const int32 Index : Finished)
+	{
+		if (const auto Visual = State.Payloads[Index].Visual.Get())
+		{
+			ReleaseVisual(Visual);
+		}
+
+		State.RemoveAtSwap(Index);
+	}
+}
+
+void UProjectileSimSubsystem::ApplyImpact(const FProjectileImpact& Impact, bool HasAuthority) const
+{
+	const auto OtherActor = Impact.Hit.GetActor();
+	const auto OtherComp = Impact.Hit.GetComponent();
+
+	// Same impulse AHeraProjectile::OnHit gives physics objects
+	if (OtherComp && OtherComp->IsSimulatingPhysics())
+	{
+		OtherComp->AddImpulseAtLocation(Impact.Velocity * 100.0f, Impact.Hit.ImpactPoint);
+	}
+
+	if (HasAuthority && OtherActor)
+	{
+		UAbilitySystemComponentBase::ApplyHitDamage(
+			OtherActor, 
+			Impact.Payload.Instigator.Get(), 
+			Impact.Payload.EffectSpecHandle, 
+			Impact.Payload.DirectDamage
+		);
+	}
+}
+
+void UProjectileSimSubsystem::UpdateVisuals()
+{
+	const int32 Count = State.Num();
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		if (const auto Visual = State.Payloads[Index].Visual.Get())
+		{
+			Visual->SetActorLocationAndRotation(State.Positions[Index], State.Velocities[Index].Rotation());
+		}
+	}
+}
+
+AProjectileBase* UProjectileSimSubsystem::AcquireVisual(
+	TSubclassOf<AProjectileBase> VisualClass,
+	const FVector& Location,
+	const FRotator& Rotation
+)
+{
+	const int32 FreeIndex = FreeVisuals.IndexOfByPredicate([VisualClass](const AProjectileBase* Visual)
+	{
+		return IsValid(Visual) && Visual->GetClass() == VisualClass;
+	});
+
+	if (FreeIndex != INDEX_NONE)
+	{
+		const auto Visual = FreeVisuals[FreeIndex].Get();
+		FreeVisuals.RemoveAtSwap(FreeIndex, 1, false);
+		Visual->SetActorLocationAndRotation(Location, Rotation);
+		Visual->SetActorHiddenInGame(false);
+		return Visual;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParams.bDeferConstruction = true;
+
+	const FTransform SpawnTransform(Rotation, Location);
+	const auto Visual = GetWorld()->SpawnActor<AProjectileBase>(VisualClass, SpawnTransform, SpawnParams);
+	if (Visual)
+	{
+		// Every machine shows its own visuals
+		Visual->IsVisualOnly = true;
+		Visual->SetReplicates(false);
+		Visual->FinishSpawning(SpawnTransform);
+	}
+
+	return Visual;
+}
+
+void UProjectileSimSubsystem::ReleaseVisual(AProjectileBase* Visual)
+{
+	Visual->SetActorHiddenInGame(true);
+	FreeVisuals.Add(Visual);
+}
@@ -0,0 +1,210 @@
+// Copyright Final Fall Games. All Rights Reserved.
+
+#include "core/subsystems/significance_subsystem.h"
+#include "core/actors/base_character_actor.h"
+#include "core/hera_stats.h"
+
+#include "Camera/PlayerCameraManager.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("SignificanceUpdate"), STAT_Hera_SignificanceUpdate, STATGROUP_Hera);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Characters throttled"), STAT_Hera_CharactersThrottled, STATGROUP_Hera);
+
+static TAutoConsoleVariable<int32> CVarSignificance(
+	TEXT("Hera.Significance"),
+	1,
+	TEXT("Throttle characters by how much they matter to the local player. 0 updates every character at full rate."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<int32> CVarSignificanceMaxHigh(
+	TEXT("Hera.Significance.MaxHigh"),
+	8,
+	TEXT("Most characters updated at full rate, besides the local player's."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<int32> CVarSignificanceMaxMedium(
+	TEXT("Hera.Significance.MaxMedium"),
+	12,
+	TEXT("Most characters updated at the medium rate. The rest are low."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarSignificanceCullDistance(
+	TEXT("Hera.Significance.CullDistance"),
+	8000.0f,
+	TEXT("Characters further than this from the view, in cm, barely update and play no fire feedback."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarSignificanceUpdateInterval(
+	TEXT("Hera.Significance.UpdateInterval"),
+	0.25f,
+	TEXT("Seconds between re-ranking the characters."),
+	ECVF_Default
+);
+
+/// Characters rendered within this many seconds count as on screen.
+static constexpr float kRecentlyRenderedSeconds = 0.5f;
+
+const FSignificanceBudget& FSignificanceBudget::Get(ESignificance Significance)
+{
+	// Tick, animation, healthbar, fire sound, fire animation
+	static const FSignificanceBudget kBudgets[] = {
+		/* Critical */ { 0.0f,  0.0f,   0.0f,  true,  true  },
+		/* High     */ { 0.0f,  0.0f,   0.0f,  true,  true  },
+		/* Medium   */ { 0.05f, 0.033f, 0.1f,  true,  true  },
+		/* Low      */ { 0.2f,  0.1f,   0.25f, true,  false },
+		/* Culled   */ { 0.5f,  0.5f,   -1.0f, false, false },
+	};
+	return kBudgets[static_cast<uint8>(Significance)];
+}
+
+bool USignificanceSubsystem::IsEnabled()
+{
+	return CVarSignificance.GetValueOnGameThread() != 0;
+}
+
+bool USignificanceSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+bool USignificanceSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId USignificanceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USignificanceSubsystem, STATGROUP_Tickables);
+}
+
+void USignificanceSubsystem::Deinitialize()
+{
+	Characters.Reset();
+	Ranked.Reset();
+
+	Super::Deinitialize();
+}
+
+void USignificanceSubsystem::Register(ACharacterBase* Character)
+{
+	// A dedicated server in PIE still has this subsystem
+	if (Character && GetWorld()->GetNetMode() != NM_DedicatedServer)
+	{
+		Characters.AddUnique(Character);
+	}
+}
+
+void USignificanceSubsystem::Unregister(ACharacterBase* Character)
+{
+	Characters.RemoveSwap(Character);
+}
+
+void USignificanceSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	TimeUntilUpdate -= DeltaTime;
+	if (TimeUntilUpdate > 0.0f || Characters.Num() == 0)
+	{
+		return;
+	}
+	TimeUntilUpdate = CVarSignificanceUpdateInterval.GetValueOnGameThread();
+
+	FVector ViewLocation;
+	float FOVDegrees;
+	if (GetViewPoint(ViewLocation, FOVDegrees))
+	{
+		Update(ViewLocation, FOVDegrees);
+	}
+}
+
+bool USignificanceSubsystem::GetViewPoint(FVector& OutLocation, float& OutFOVDegrees) const
+{
+	const auto PlayerController = GetWorld()->GetFirstPlayerController();
+	if (!PlayerController || !PlayerController->IsLocalController())
+	{
+		return false;
+	}
+
+	FRotator ViewRotation;
+	PlayerController->GetPlayerViewPoint(OutLocation, ViewRotation);
+	OutFOVDegrees = PlayerController->PlayerCameraManager ? PlayerController->PlayerCameraManager->GetFOVAngle() : 90.0f;
+	return true;
+}
+
+void USignificanceSubsystem::Update(const FVector& ViewLocation, float FOVDegrees)
+{
+	HERA_SCOPE_CYCLE_COUNTER(SignificanceUpdate);
+
+	Characters.RemoveAllSwap([](const TWeakObjectPtr<ACharacterBase>& Character) { return !Character.IsValid(); });
+
+	if (!IsEnabled())
+	{
+		for (const auto& Character : Characters)
+		{
+			Character->SetSignificance(ESignificance::Critical);
+		}
+		return;
+	}
+
+	const float CullDistanceSquared = FMath::Square(CVarSignificanceCullDistance.GetValueOnGameThread());
+	const float TanHalfFOV = FMath::Tan(FMath::DegreesToRadians(FMath::Clamp(FOVDegrees, 1.0f, 170.0f) * 0.5f));
+
+	// Sort out the characters whose significance doesn't depend on the others first
+	Ranked.Reset();
+	int32 NumThrottled = 0;
+	for (const auto& WeakCharacter : Characters)
+	{
+		const auto Character = WeakCharacter.Get();
+		const float DistanceSquared = FVector::DistSquared(ViewLocation, Character->GetActorLocation());
+
+		ESignificance Significance;
+		if (Character->IsLocallyControlled())
+		{
+			Significance = ESignificance::Critical;
+		}
+		else if (DistanceSquared > CullDistanceSquared)
+		{
+			Significance = ESignificance::Culled;
+		}
+		else if (!Character->WasRecentlyRendered(kRecentlyRenderedSeconds))
+		{
+			Significance = ESignificance::Low;
+		}
+		else
+		{
+			const float Radius = Character->GetCapsuleComponent()->GetScaledCapsuleRadius();
+			const float Distance = FMath::Max(FMath::Sqrt(DistanceSquared), 1.0f);
+			Ranked.Add({ Character, Radius / (Distance * TanHalfFOV) });
+			continue;
+		}
+
+		NumThrottled += Significance > ESignificance::High;
+		Character->SetSignificance(Significance);
+	}
+
+	// Then hand out the budgets, largest on screen first
+	Ranked.Sort([](const FRankedCharacter& A, const FRankedCharacter& B) { return A.ScreenSize > B.ScreenSize; });
+
+	const int32 MaxHigh = FMath::Max(CVarSignificanceMaxHigh.GetValueOnGameThread(), 0);
+	const int32 MaxMedium = MaxHigh + FMath::Max(CVarSignificanceMaxMedium.GetValueOnGameThread(), 0);
+	for (int32 Rank = 0; Rank < Ranked.Num(); ++Rank)
+	{
+		const ESignificance Significance =
+			Rank < MaxHigh ? ESignificance::High :
+			Rank < MaxMedium ? ESignificance::Medium :
+			ESignificance::Low;
+
+		NumThrottled += Significance > ESignificance::High;
+		Ranked[Rank].Character->SetSignificance(Significance);
+	}
+
+	SET_DWORD_STAT(STAT_Hera_CharactersThrottled, NumThrottled);
+}
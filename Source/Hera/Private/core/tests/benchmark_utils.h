@@ -0,0 +1,141 @@
+// Copyright Final Fall Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/PlatformMemory.h"
+#include "UObject/UObjectArray.h"
+
+/// NOTES:
+// Benchmarks are automation tests under Hera.Benchmark and run headless, e.g.
+//   HeraEditor.exe Hera.uproject -nullrhi -unattended -nosplash
+//     -ExecCmds="Automation RunTests Hera.Benchmark; Quit"
+// Each benchmark reports to the automation log and to LogTemp:
+//  - ops/sec over the whole run
+//  - p50/p99 time of a single operation
+//  - change in live UObjects and used physical memory across the run, as a proxy for allocations
+
+/// Collects the timing of every operation of one benchmark.
+struct FHeraBenchmark
+{
+	explicit FHeraBenchmark(const TCHAR* InName, int32 ExpectedOps = 0)
+		: Name(InName)
+	{
+		OpCycles.Reserve(ExpectedOps);
+	}
+
+	/// Snapshot memory and start the clock. Call once setup is done.
+	void Begin()
+	{
+		OpCycles.Reset();
+		StartObjects = GUObjectArray.GetObjectArrayNumMinusAvailable();
+		StartMemory = FPlatformMemory::GetStats().UsedPhysical;
+		StartTime = FPlatformTime::Cycles64();
+	}
+
+	FORCEINLINE void StartOp()
+	{
+		OpStart = FPlatformTime::Cycles64();
+	}
+
+	FORCEINLINE void StopOp()
+	{
+		OpCycles.Add(FPlatformTime::Cycles64() - OpStart);
+	}
+
+	/// Stop the clock and snapshot memory again.
+	void End()
+	{
+		TotalCycles = FPlatformTime::Cycles64() - StartTime;
+		EndObjects = GUObjectArray.GetObjectArrayNumMinusAvailable();
+		EndMemory = FPlatformMemory::GetStats().UsedPhysical;
+	}
+
+	/// Seconds of the operation at the given percentile [0, 1].
+	static double GetPercentile(const TArray<uint64>& SortedCycles, double Percentile)
+	{
+		if (SortedCycles.Num() == 0)
+		{
+			return 0.0;
+		}
+
+		const int32 Index = FMath::Clamp(FMath::FloorToInt(Percentile * SortedCycles.Num()), 0, SortedCycles.Num() - 1);
+		return FPlatformTime::ToSeconds64(SortedCycles[Index]);
+	}
+
+	void Report(FAutomationTestBase& Test) const
+	{
+		auto SortedCycles = OpCycles;
+		SortedCycles.Sort();
+
+		const double TotalSeconds = FPlatformTime::ToSeconds64(TotalCycles);
+		const double OpsPerSecond = TotalSeconds > 0.0 ? OpCycles.Num() / TotalSeconds : 0.0;
+		const int64 ObjectDelta = static_cast<int64>(EndObjects) - static_cast<int64>(StartObjects);
+		const double MemoryDeltaKiB = (static_cast<double>(EndMemory) - static_cast<double>(StartMemory)) / 1024.0;
+
+		const auto Message = FString::Printf(
+			TEXT("%s: %d ops in %.2f ms | %.0f ops/sec | p50 %.2f us | p99 %.2f us | UObjects %+lld | memory %+.1f KiB"),
+			*Name,
+			OpCycles.Num(),
+			TotalSeconds * 1000.0,
+			OpsPerSecond,
+			GetPercentile(SortedCycles, 0.5) * 1000000.0,
+			GetPercentile(SortedCycles, 0.99) * 1000000.0,
+			ObjectDelta,
+			MemoryDeltaKiB
+		);
+
+		Test.AddInfo(Message);
+		UE_LOG(LogTemp, Display, TEXT("%s"), *Message);
+	}
+
+	FString Name;
+	TArray<uint64> OpCycles;
+	uint64 OpStart = 0;
+	uint64 StartTime = 0;
+	uint64 TotalCycles = 0;
+	int32 StartObjects = 0;
+	int32 EndObjects = 0;
+	uint64 StartMemory = 0;
+	uint64 EndMemory = 0;
+};
+
+/// A standalone game world for benchmarks. Torn down when it goes out of scope.
+struct FHeraBenchmarkWorld
+{
+	FHeraBenchmarkWorld()
+	{
+		World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("HeraBenchmarkWorld"));
+
+		auto& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+		WorldContext.SetCurrentWorld(World);
+
+		World->InitializeActorsForPlay(FURL());
+		World->BeginPlay();
+	}
+
+	~FHeraBenchmarkWorld()
+	{
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	}
+
+	UWorld* Get() const { return World; }
+
+	/// Runs timers and actor ticks, e.g. to flush damage coalesced for the frame.
+	void Tick(float DeltaSeconds = 1.0f / 60.0f)
+	{
+		World->Tick(LEVELTICK_All, DeltaSeconds);
+	}
+
+	UWorld* World = nullptr;
+};
+
+#endif // WITH_DEV_AUTOMATION_TESTS
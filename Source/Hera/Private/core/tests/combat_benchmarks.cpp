@@ -0,0 +1,788 @@
+// Copyright Final Fall Games. All Rights Reserved.
+
+#include "benchmark_utils.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "core/actors/base_character_actor.h"
+#include "core/actors/projectile_actor.h"
+#include "core/gas/abilities/base_ability.h"
+#include "core/gas/abilities/damage_execution.h"
+#include "core/gas/abilities/healing_execution.h"
+#include "core/gas/abilities/jump_ability.h"
+#include "core/gas/base_asc.h"
+#include "core/gas/life_attribute_set.h"
+#include "core/gas/life_pool_kernel.h"
+#include "core/gas/tags.h"
+#include "core/subsystems/lag_compensation_subsystem.h"
+#include "core/subsystems/projectile_pool_subsystem.h"
+#include "core/subsystems/projectile_sim_subsystem.h"
+
+#include "Algo/Find.h"
+#include "Components/SphereComponent.h"
+#include "Engine/DemoNetDriver.h"
+#include "HAL/IConsoleManager.h"
+#include "GameplayEffect.h"
+#include "UObject/StrongObjectPtr.h"
+
+namespace HeraBenchmark
+{
+	constexpr auto kTestFlags = EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter;
+
+	constexpr int32 kNumCharacters = 200;
+	constexpr int32 kNumApplications = 20000;
+	constexpr int32 kNumProjectiles = 5000;
+	constexpr int32 kNumKernelPools = 10000;
+	constexpr int32 kNumKernelFrames = 1000;
+	constexpr int32 kNumSimFrames = 120;
+	constexpr int32 kNumRewindQueries = 10000;
+	constexpr int32 kNumReplicationFrames = 600;
+
+	/// Characters hit per replicated frame. The others have nothing new to send.
+	constexpr int32 kNumHitsPerFrame = 20;
+	constexpr float kReplicationHz = 60.0f;
+
+	/// Large enough that nobody dies during a run.
+	constexpr float kPoolSize = 1000000000.0f;
+
+	/// Spawn a character with an initialized ASC and a full health pool.
+	ACharacterBase* SpawnCharacter(UWorld* World, int32 Index)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		const FVector Location(200.0f * (Index % 32), 200.0f * (Index / 32), 100.0f);
+		auto Character = World->SpawnActor<ACharacterBase>(
+			ACharacterBase::StaticClass(), 
+			Location, 
+			FRotator::ZeroRotator, 
+			SpawnParams
+		);
+		if (!Character)
+		{
+			return nullptr;
+		}
+
+		auto ASC = Character->GetAbilitySystemComponent();
+		ASC->InitAbilityActorInfo(Character, Character);
+		ASC->SetNumericAttributeBase(ULifeAttributeSet::GetMaxHealthAttribute(), kPoolSize);
+		ASC->SetNumericAttributeBase(ULifeAttributeSet::GetHealthAttribute(), kPoolSize);
+		ASC->SetNumericAttributeBase(ULifeAttributeSet::GetMaxShieldsAttribute(), kPoolSize);
+		ASC->SetNumericAttributeBase(ULifeAttributeSet::GetShieldsAttribute(), kPoolSize);
+		ASC->SetNumericAttributeBase(ULifeAttributeSet::GetMaxArmorAttribute(), kPoolSize);
+		ASC->SetNumericAttributeBase(ULifeAttributeSet::GetArmorAttribute(), kPoolSize);
+		return Character;
+	}
+
+	void SpawnCharacters(UWorld* World, int32 Count, TArray<ACharacterBase*>& OutCharacters)
+	{
+		OutCharacters.Reserve(Count);
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			if (auto Character = SpawnCharacter(World, Index))
+			{
+				OutCharacters.Add(Character);
+			}
+		}
+	}
+
+	/// Instant GameplayEffect running the given execution, like the damage and healing GEs made in Blueprint.
+	TStrongObjectPtr<UGameplayEffect> MakeExecutionEffect(TSubclassOf<UGameplayEffectExecutionCalculation> Calculation)
+	{
+		auto Effect = NewObject<UGameplayEffect>(GetTransientPackage());
+		Effect->DurationPolicy = EGameplayEffectDurationType::Instant;
+
+		FGameplayEffectExecutionDefinition Execution;
+		Execution.CalculationClass = Calculation;
+		Effect->Executions.Add(Execution);
+
+		return TStrongObjectPtr<UGameplayEffect>(Effect);
+	}
+
+	/// Apply Effect from a random character to another kNumApplications times and report it.
+	void RunExecutionBenchmark(
+		FAutomationTestBase& Test, 
+		const TCHAR* Name, 
+		TSubclassOf<UGameplayEffectExecutionCalculation> Calculation, 
+		const FGameplayTag& SetByCallerTag
+	)
+	{
+		FHeraBenchmarkWorld World;
+		TArray<ACharacterBase*> Characters;
+		SpawnCharacters(World.Get(), kNumCharacters, Characters);
+		if (Characters.Num() < 2)
+		{
+			Test.AddError(TEXT("Failed to spawn characters"));
+			return;
+		}
+
+		const auto Effect = MakeExecutionEffect(Calculation);
+		FRandomStream Random(1234);
+
+		FHeraBenchmark Benchmark(Name, kNumApplications);
+		Benchmark.Begin();
+		for (int32 Index = 0; Index < kNumApplications; ++Index)
+		{
+			auto SourceASC = Characters[Random.RandHelper(Characters.Num())]->GetAbilitySystemComponent();
+			auto TargetASC = Characters[Random.RandHelper(Characters.Num())]->GetAbilitySystemComponent();
+
+			Benchmark.StartOp();
+			FGameplayEffectSpec Spec(Effect.Get(), SourceASC->MakeEffectContext(), 1.0f);
+			Spec.SetSetByCallerMagnitude(SetByCallerTag, 10.0f);
+			SourceASC->ApplyGameplayEffectSpecToTarget(Spec, TargetASC);
+			Benchmark.StopOp();
+		}
+		Benchmark.End();
+		Benchmark.Report(Test);
+
+		// Commit whatever was coalesced this frame
+		FHeraBenchmark Flush(*FString::Printf(TEXT("%s (frame flush)"), Name), 1);
+		Flush.Begin();
+		Flush.StartOp();
+		World.Tick();
+		Flush.StopOp();
+		Flush.End();
+		Flush.Report(Test);
+	}
+
+	/// Record a replay of World in memory. The replay's net driver compares and sends the replicated properties of
+	/// every actor like the game's net driver does for a client, without needing one.
+	UDemoNetDriver* StartRecording(UWorld* World)
+	{
+		const FName DriverName(TEXT("DemoNetDriver"));
+		if (!GEngine->CreateNamedNetDriver(World, DriverName, DriverName))
+		{
+			return nullptr;
+		}
+
+		const auto DemoNetDriver = Cast<UDemoNetDriver>(GEngine->FindNamedNetDriver(World, DriverName));
+		if (!DemoNetDriver)
+		{
+			GEngine->DestroyNamedNetDriver(World, DriverName);
+			return nullptr;
+		}
+
+		FURL URL;
+		URL.Map = TEXT("HeraReplicationBenchmark");
+		URL.AddOption(TEXT("ReplayStreamerOverride=InMemoryNetworkReplayStreaming"));
+
+		FString Error;
+		DemoNetDriver->SetWorld(World);
+		World->SetDemoNetDriver(DemoNetDriver);
+		if (!DemoNetDriver->InitListen(World, URL, false, Error))
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s() Failed to record a replay: %s"), *FString(__FUNCTION__), *Error);
+			World->SetDemoNetDriver(nullptr);
+			GEngine->DestroyNamedNetDriver(World, DriverName);
+			return nullptr;
+		}
+
+		return DemoNetDriver;
+	}
+
+	void StopRecording(UWorld* World, UDemoNetDriver* DemoNetDriver)
+	{
+		DemoNetDriver->StopDemo();
+		World->SetDemoNetDriver(nullptr);
+		GEngine->DestroyNamedNetDriver(World, DemoNetDriver->NetDriverName);
+	}
+
+	/// Tick kNumReplicationFrames frames of kNumCharacters, kNumHitsPerFrame of them taking damage each frame, and
+	/// report the time of a frame. Replicates them to a replay when IsRecording.
+	void RunReplicationBenchmark(FAutomationTestBase& Test, const TCHAR* Name, bool IsRecording)
+	{
+		FHeraBenchmarkWorld World;
+		TArray<ACharacterBase*> Characters;
+		SpawnCharacters(World.Get(), kNumCharacters, Characters);
+		if (Characters.Num() < 2)
+		{
+			Test.AddError(TEXT("Failed to spawn characters"));
+			return;
+		}
+
+		UDemoNetDriver* DemoNetDriver = nullptr;
+		if (IsRecording)
+		{
+			DemoNetDriver = StartRecording(World.Get());
+			if (!DemoNetDriver)
+			{
+				Test.AddError(TEXT("Failed to record a replay"));
+				return;
+			}
+		}
+
+		FRandomStream Random(1234);
+		FHeraBenchmark Benchmark(Name, kNumReplicationFrames);
+		Benchmark.Begin();
+		for (int32 Frame = 0; Frame < kNumReplicationFrames; ++Frame)
+		{
+			// The hits are timed too, marking the attributes dirty is what the push model costs
+			Benchmark.StartOp();
+			for (int32 Hit = 0; Hit < kNumHitsPerFrame; ++Hit)
+			{
+				auto SourceASC = Cast<UAbilitySystemComponentBase>(
+					Characters[Random.RandHelper(Characters.Num())]->GetAbilitySystemComponent()
+				);
+				auto TargetASC = Cast<UAbilitySystemComponentBase>(
+					Characters[Random.RandHelper(Characters.Num())]->GetAbilitySystemComponent()
+				);
+				TargetASC->ApplyDirectDamage(SourceASC, 10.0f);
+			}
+			World.Tick(1.0f / kReplicationHz);
+			Benchmark.StopOp();
+		}
+		Benchmark.End();
+		Benchmark.Report(Test);
+
+		if (DemoNetDriver)
+		{
+			StopRecording(World.Get(), DemoNetDriver);
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// MARK: - Life pool
+//---------------------------------------------------------------------------------------------------------------------
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FHeraLifePoolKernelBenchmark, 
+	"Hera.Benchmark.LifePoolKernel", 
+	HeraBenchmark::kTestFlags
+)
+bool FHeraLifePoolKernelBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace HeraBenchmark;
+
+	FLifePoolSoA Pools;
+	Pools.Reserve(kNumKernelPools);
+	for (int32 Index = 0; Index < kNumKernelPools; ++Index)
+	{
+		FLifePoolValues Pool;
+		Pool.OverArmor = 25.0f;
+		Pool.Armor = Pool.MaxArmor = 100.0f;
+		Pool.Shields = Pool.MaxShields = 100.0f;
+		Pool.Health = Pool.MaxHealth = kPoolSize;
+		Pools.Add(Pool);
+	}
+
+	// Four hits per pool per frame, scattered
+	FRandomStream Random(1234);
+	TArray<FLifePoolEvent> Events;
+	Events.SetNum(kNumKernelPools * 4);
+	for (auto& Event : Events)
+	{
+		Event.PoolIndex = Random.RandHelper(kNumKernelPools);
+		Event.Amount = Random.FRandRange(1.0f, 20.0f);
+	}
+
+	TArray<float> Scratch;
+	FHeraBenchmark Benchmark(TEXT("LifePoolKernel ResolveDamage (one frame)"), kNumKernelFrames);
+	Benchmark.Begin();
+	for (int32 Frame = 0; Frame < kNumKernelFrames; ++Frame)
+	{
+		Benchmark.StartOp();
+		HeraLifePool::ResolveDamage(Pools, Events, Scratch);
+		HeraLifePool::ResolveHealing(Pools, Events, Scratch);
+		Benchmark.StopOp();
+	}
+	Benchmark.End();
+	Benchmark.Report(*this);
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// MARK: - Executions
+//---------------------------------------------------------------------------------------------------------------------
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FHeraDamageExecutionBenchmark, 
+	"Hera.Benchmark.DamageExecution", 
+	HeraBenchmark::kTestFlags
+)
+bool FHeraDamageExecutionBenchmark::RunTest(const FString& Parameters)
+{
+	HeraBenchmark::RunExecutionBenchmark(
+		*this, 
+		TEXT("DamageExecution"), 
+		UDamageExecution::StaticClass(), 
+		HeraTags::Tag_Damage
+	);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FHeraHealingExecutionBenchmark, 
+	"Hera.Benchmark.HealingExecution", 
+	HeraBenchmark::kTestFlags
+)
+bool FHeraHealingExecutionBenchmark::RunTest(const FString& Parameters)
+{
+	HeraBenchmark::RunExecutionBenchmark(
+		*this, 
+		TEXT("HealingExecution"), 
+		UHealingExecution::StaticClass(), 
+		HeraTags::Tag_Healing
+	);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FHeraDirectDamageBenchmark, 
+	"Hera.Benchmark.DirectDamage", 
+	HeraBenchmark::kTestFlags
+)
+bool FHeraDirectDamageBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace HeraBenchmark;
+
+	FHeraBenchmarkWorld World;
+	TArray<ACharacterBase*> Characters;
+	SpawnCharacters(World.Get(), kNumCharacters, Characters);
+	if (Characters.Num() < 2)
+	{
+		AddError(TEXT("Failed to spawn characters"));
+		return false;
+	}
+
+	FRandomStream Random(1234);
+	FHeraBenchmark Benchmark(TEXT("ApplyDirectDamage"), kNumApplications);
+	Benchmark.Begin();
+	for (int32 Index = 0; Index < kNumApplications; ++Index)
+	{
+		auto SourceASC = Cast<UAbilitySystemComponentBase>(
+			Characters[Random.RandHelper(Characters.Num())]->GetAbilitySystemComponent()
+		);
+		auto TargetASC = Cast<UAbilitySystemComponentBase>(
+			Characters[Random.RandHelper(Characters.Num())]->GetAbilitySystemComponent()
+		);
+
+		Benchmark.StartOp();
+		TargetASC->ApplyDirectDamage(SourceASC, 10.0f);
+		Benchmark.StopOp();
+	}
+	Benchmark.End();
+	Benchmark.Report(*this);
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// MARK: - Projectiles
+//---------------------------------------------------------------------------------------------------------------------
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FHeraProjectileBenchmark, 
+	"Hera.Benchmark.Projectiles", 
+	HeraBenchmark::kTestFlags
+)
+bool FHeraProjectileBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace HeraBenchmark;
+
+	FHeraBenchmarkWorld World;
+	TArray<ACharacterBase*> Characters;
+	SpawnCharacters(World.Get(), 1, Characters);
+	if (Characters.Num() == 0)
+	{
+		AddError(TEXT("Failed to spawn the target character"));
+		return false;
+	}
+
+	auto Target = Characters[0];
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	TArray<AHeraProjectile*> Projectiles;
+	Projectiles.Reserve(kNumProjectiles);
+
+	FHeraBenchmark Spawn(TEXT("AHeraProjectile spawn"), kNumProjectiles);
+	Spawn.Begin();
+	for (int32 Index = 0; Index < kNumProjectiles; ++Index)
+	{
+		Spawn.StartOp();
+		auto Projectile = World.Get()->SpawnActor<AHeraProjectile>(
+			AHeraProjectile::StaticClass(), 
+			Target->GetActorLocation() - FVector(1000.0f, 0.0f, 0.0f), 
+			FRotator::ZeroRotator, 
+			SpawnParams
+		);
+		Spawn.StopOp();
+
+		if (Projectile)
+		{
+			Projectiles.Add(Projectile);
+		}
+	}
+	Spawn.End();
+	Spawn.Report(*this);
+
+	// Deliver a hit to every projectile, then tear them down the way a hit or an expired lifespan does
+	const auto TargetComp = Cast<UPrimitiveComponent>(Target->GetRootComponent());
+	const FHitResult Hit(Target, TargetComp, Target->GetActorLocation(), FVector::BackwardVector);
+
+	FHeraBenchmark HitAndDestroy(TEXT("AHeraProjectile hit + destroy"), Projectiles.Num());
+	HitAndDestroy.Begin();
+	for (auto Projectile : Projectiles)
+	{
+		HitAndDestroy.StartOp();
+		Projectile->OnHit(Projectile->GetCollisionComp(), Target, TargetComp, FVector::ZeroVector, Hit);
+		Projectile->Destroy();
+		HitAndDestroy.StopOp();
+	}
+	HitAndDestroy.End();
+	HitAndDestroy.Report(*this);
+
+	// Same shots through the pool once it's warm: a launch and a retire instead of a spawn and a destroy
+	const auto ProjectilePool = World.Get()->GetSubsystem<UProjectilePoolSubsystem>();
+	if (!ProjectilePool)
+	{
+		AddError(TEXT("The benchmark world has no projectile pool"));
+		return false;
+	}
+
+	const FTransform SpawnTransform(Target->GetActorLocation() - FVector(1000.0f, 0.0f, 0.0f));
+	ProjectilePool->Prewarm(AHeraProjectile::StaticClass(), 1);
+
+	FHeraBenchmark Pooled(TEXT("AHeraProjectile pooled acquire + release"), kNumProjectiles);
+	Pooled.Begin();
+	for (int32 Index = 0; Index < kNumProjectiles; ++Index)
+	{
+		Pooled.StartOp();
+		if (auto Projectile = ProjectilePool->Acquire(AHeraProjectile::StaticClass(), SpawnTransform))
+		{
+			Projectile->Release();
+		}
+		Pooled.StopOp();
+	}
+	Pooled.End();
+	Pooled.Report(*this);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FHeraProjectileSimBenchmark, 
+	"Hera.Benchmark.ProjectileSim", 
+	HeraBenchmark::kTestFlags
+)
+bool FHeraProjectileSimBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace HeraBenchmark;
+
+	const auto SweepMode = IConsoleManager::Get().FindConsoleVariable(TEXT("Hera.Projectile.SweepMode"));
+	const int32 OriginalSweepMode = SweepMode ? SweepMode->GetInt() : 0;
+	const TCHAR* SweepModeNames[] = { TEXT("game thread"), TEXT("ParallelFor"), TEXT("async") };
+
+	for (int32 Mode = 0; Mode < UE_ARRAY_COUNT(SweepModeNames); ++Mode)
+	{
+		if (SweepMode)
+		{
+			SweepMode->Set(Mode, ECVF_SetByCode);
+		}
+
+		FHeraBenchmarkWorld World;
+		const auto ProjectileSim = World.Get()->GetSubsystem<UProjectileSimSubsystem>();
+		if (!ProjectileSim)
+		{
+			AddError(TEXT("The benchmark world has no projectile simulation"));
+			break;
+		}
+
+		// Projectiles fanned out from the origin that live through every frame of the benchmark
+		FRandomStream Random(1337);
+		for (int32 Index = 0; Index < kNumProjectiles; ++Index)
+		{
+			FProjectileLaunchParams Params;
+			Params.Origin = Random.VRand() * 100.0f;
+			Params.Velocity = Random.VRand() * 11000.0f;
+			Params.GravityScale = 1.0f;
+			Params.LifeSpan = kNumSimFrames;
+			ProjectileSim->Launch(Params);
+		}
+
+		// The whole world ticks so async sweeps come back the way they do in game, one frame after they're issued
+		FHeraBenchmark Benchmark(*FString::Printf(TEXT("World tick with UProjectileSimSubsystem, %s sweeps"), SweepModeNames[Mode]), kNumSimFrames);
+		Benchmark.Begin();
+		for (int32 Frame = 0; Frame < kNumSimFrames; ++Frame)
+		{
+			Benchmark.StartOp();
+			World.Tick();
+			Benchmark.StopOp();
+		}
+		Benchmark.End();
+		Benchmark.Report(*this);
+
+		// A late sweep runs on the game thread, so async sweeps are only worth it when none are late
+		const uint32 NumSweepsLate = ProjectileSim->GetNumSweepsLate();
+		const auto Message = FString::Printf(TEXT("%s sweeps: %u late of %d"), SweepModeNames[Mode], NumSweepsLate, kNumProjectiles * kNumSimFrames);
+		AddInfo(Message);
+		UE_LOG(LogTemp, Display, TEXT("%s"), *Message);
+
+		if (NumSweepsLate > 0)
+		{
+			AddError(FString::Printf(TEXT("%u projectile sweeps were late"), NumSweepsLate));
+		}
+	}
+
+	if (SweepMode)
+	{
+		SweepMode->Set(OriginalSweepMode, ECVF_SetByCode);
+	}
+
+	return !HasAnyErrors();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// MARK: - Lag compensation
+//---------------------------------------------------------------------------------------------------------------------
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FHeraLagCompensationBenchmark, 
+	"Hera.Benchmark.LagCompensation", 
+	HeraBenchmark::kTestFlags
+)
+bool FHeraLagCompensationBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace HeraBenchmark;
+
+	FHeraBenchmarkWorld World;
+	TArray<ACharacterBase*> Characters;
+	SpawnCharacters(World.Get(), kNumCharacters, Characters);
+
+	// Characters register themselves in BeginPlay
+	const auto LagCompensation = World.Get()->GetSubsystem<ULagCompensationSubsystem>();
+	if (!LagCompensation || LagCompensation->GetNumRecorded() < kNumCharacters)
+	{
+		AddError(TEXT("Characters weren't registered for lag compensation"));
+		return false;
+	}
+
+	constexpr int32 kBytesPerCharacter = kLagCompensationFrames 
+		* (sizeof(FVector3f) + sizeof(float) + kLagCompensationMaxHitZones * sizeof(FVector3f));
+	AddInfo(FString::Printf(
+		TEXT("Lag compensation history: %d bytes per character, %.1f KiB for %d characters"),
+		kBytesPerCharacter,
+		kBytesPerCharacter * Characters.Num() / 1024.0f,
+		Characters.Num()
+	));
+
+	// Fill the whole history with everyone strafing, a frame every 1/60 s
+	constexpr float kFrameTime = 1.0f / 60.0f;
+	FHeraBenchmark Record(TEXT("ULagCompensationSubsystem record (one frame)"), kLagCompensationFrames);
+	Record.Begin();
+	for (int32 Frame = 0; Frame < kLagCompensationFrames; ++Frame)
+	{
+		for (auto Character : Characters)
+		{
+			Character->AddActorWorldOffset(FVector(0.0f, 5.0f, 0.0f));
+		}
+
+		Record.StartOp();
+		LagCompensation->Record(Frame * kFrameTime);
+		Record.StopOp();
+	}
+	Record.End();
+	Record.Report(*this);
+
+	// Shots across the whole crowd at up to 200 ms in the past
+	const float NewestTime = (kLagCompensationFrames - 1) * kFrameTime;
+	FRandomStream Random(1234);
+	int32 NumHits = 0;
+
+	FHeraBenchmark Rewind(*FString::Printf(TEXT("RewindTrace, %d characters"), Characters.Num()), kNumRewindQueries);
+	Rewind.Begin();
+	for (int32 Index = 0; Index < kNumRewindQueries; ++Index)
+	{
+		const auto Target = Characters[Random.RandHelper(Characters.Num())];
+		const FVector Start = Target->GetActorLocation() + Random.VRand() * 3000.0f;
+		const FVector End = Start + (Target->GetActorLocation() - Start) * 2.0f;
+		const float ShooterTime = NewestTime - Random.FRandRange(0.0f, 0.2f);
+
+		FLagCompensationHit Hit;
+		Rewind.StartOp();
+		NumHits += LagCompensation->RewindTrace(ShooterTime, Start, End, 0.0f, nullptr, Hit) ? 1 : 0;
+		Rewind.StopOp();
+	}
+	Rewind.End();
+	Rewind.Report(*this);
+
+	AddInfo(FString::Printf(TEXT("%d of %d rewound traces hit a character"), NumHits, kNumRewindQueries));
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// MARK: - Characters
+//---------------------------------------------------------------------------------------------------------------------
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FHeraCharacterSpawnBenchmark, 
+	"Hera.Benchmark.CharacterSpawn", 
+	HeraBenchmark::kTestFlags
+)
+bool FHeraCharacterSpawnBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace HeraBenchmark;
+
+	// Characters only skip their cosmetic components in a dedicated server process. Run this in the editor and on
+	// a server build to compare spawn times, the memory split below already shows what the server saves.
+	const TCHAR* ProcessName = IsRunningDedicatedServer() ? TEXT("dedicated server") : TEXT("client or editor");
+
+	FHeraBenchmarkWorld World;
+	TArray<ACharacterBase*> Characters;
+	Characters.Reserve(kNumCharacters);
+
+	FHeraBenchmark Spawn(*FString::Printf(TEXT("ACharacterBase spawn, %s"), ProcessName), kNumCharacters);
+	Spawn.Begin();
+	for (int32 Index = 0; Index < kNumCharacters; ++Index)
+	{
+		Spawn.StartOp();
+		const auto Character = SpawnCharacter(World.Get(), Index);
+		Spawn.StopOp();
+
+		if (Character)
+		{
+			Characters.Add(Character);
+		}
+	}
+	Spawn.End();
+	Spawn.Report(*this);
+
+	if (Characters.Num() == 0)
+	{
+		AddError(TEXT("No character spawned"));
+		return false;
+	}
+
+	const FName CosmeticNames[] = {
+		ACharacterBase::kFirstPersonCameraName,
+		ACharacterBase::kThirdPersonCameraBoomName,
+		ACharacterBase::kThirdPersonCameraName,
+		ACharacterBase::kMesh1PName,
+		ACharacterBase::kFloatingHealthbarName,
+	};
+
+	// The objects themselves, not the meshes and classes they share
+	int64 NumBytes = 0;
+	int32 NumComponents = 0;
+	int64 NumCosmeticBytes = 0;
+	int32 NumCosmeticComponents = 0;
+	for (const auto Character : Characters)
+	{
+		NumBytes += Character->GetClass()->GetStructureSize();
+		for (const auto Component : Character->GetComponents())
+		{
+			const int32 ComponentBytes = Component->GetClass()->GetStructureSize();
+			NumBytes += ComponentBytes;
+			++NumComponents;
+
+			if (Algo::Find(CosmeticNames, Component->GetFName()))
+			{
+				NumCosmeticBytes += ComponentBytes;
+				++NumCosmeticComponents;
+			}
+		}
+	}
+
+	const auto Message = FString::Printf(
+		TEXT("ACharacterBase, %s: %d components, %lld bytes of actor and components per character, ")
+		TEXT("of which %d components and %lld bytes are cosmetic and left out on a dedicated server"),
+		ProcessName,
+		NumComponents / Characters.Num(),
+		NumBytes / Characters.Num(),
+		NumCosmeticComponents / Characters.Num(),
+		NumCosmeticBytes / Characters.Num()
+	);
+	AddInfo(Message);
+	UE_LOG(LogTemp, Display, TEXT("%s"), *Message);
+
+	return !HasAnyErrors();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// MARK: - Replication
+//---------------------------------------------------------------------------------------------------------------------
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FHeraReplicationBenchmark, 
+	"Hera.Benchmark.Replication", 
+	HeraBenchmark::kTestFlags
+)
+bool FHeraReplicationBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace HeraBenchmark;
+
+	const auto PushModel = IConsoleManager::Get().FindConsoleVariable(TEXT("net.IsPushModelEnabled"));
+	const auto RecordHz = IConsoleManager::Get().FindConsoleVariable(TEXT("demo.RecordHz"));
+	if (!PushModel || !RecordHz)
+	{
+		AddError(TEXT("net.IsPushModelEnabled or demo.RecordHz is missing, is the target built with bWithPushModel?"));
+		return false;
+	}
+	const int32 OriginalPushModel = PushModel->GetInt();
+	const float OriginalRecordHz = RecordHz->GetFloat();
+
+	// Replicate every frame, like a server at the characters' NetUpdateFrequency
+	RecordHz->Set(kReplicationHz, ECVF_SetByCode);
+
+	// The same frames without replication. What the runs below take on top of it is the replication.
+	RunReplicationBenchmark(*this, TEXT("Replication frame (not replicating)"), false);
+
+	PushModel->Set(0, ECVF_SetByCode);
+	RunReplicationBenchmark(*this, TEXT("Replication frame (comparing every property)"), true);
+
+	PushModel->Set(1, ECVF_SetByCode);
+	RunReplicationBenchmark(*this, TEXT("Replication frame (push model)"), true);
+
+	PushModel->Set(OriginalPushModel, ECVF_SetByCode);
+	RecordHz->Set(OriginalRecordHz, ECVF_SetByCode);
+	return !HasAnyErrors();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// MARK: - Abilities
+//---------------------------------------------------------------------------------------------------------------------
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FHeraGrantAbilitiesBenchmark, 
+	"Hera.Benchmark.GrantAbilities", 
+	HeraBenchmark::kTestFlags
+)
+bool FHeraGrantAbilitiesBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace HeraBenchmark;
+
+	FHeraBenchmarkWorld World;
+	TArray<ACharacterBase*> Characters;
+	SpawnCharacters(World.Get(), kNumCharacters, Characters);
+
+	const TArray<TSubclassOf<UAbilityBase>> Abilities = {
+		UAbilityBase::StaticClass(),
+		UJumpAbility::StaticClass()
+	};
+
+	FHeraBenchmark Benchmark(TEXT("GiveAbility"), Characters.Num() * Abilities.Num());
+	Benchmark.Begin();
+	for (auto Character : Characters)
+	{
+		auto ASC = Character->GetAbilitySystemComponent();
+		for (const auto& Ability : Abilities)
+		{
+			Benchmark.StartOp();
+			ASC->GiveAbility(FGameplayAbilitySpec(
+				Ability, 
+				1, 
+				static_cast<int32>(Ability.GetDefaultObject()->AbilityInputID), 
+				Character
+			));
+			Benchmark.StopOp();
+		}
+	}
+	Benchmark.End();
+	Benchmark.Report(*this);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
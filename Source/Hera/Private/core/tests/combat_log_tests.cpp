@@ -0,0 +1,88 @@
+// Copyright Final Fall Games. All Rights Reserved.
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "core/logging/combat_log.h"
+
+#include "HAL/FileManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+
+namespace HeraCombatLogTests
+{
+	constexpr auto kTestFlags = EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter;
+
+	constexpr int32 kNumEvents = 1000;
+	constexpr int32 kNumActors = 8;
+}
+
+/// Everything written through FCombatLogWriter comes back out of FCombatLogReader, in order.
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHeraCombatLogRoundTripTest, "Hera.CombatLog.RoundTrip", HeraCombatLogTests::kTestFlags)
+bool FHeraCombatLogRoundTripTest::RunTest(const FString& Parameters)
+{
+	using namespace HeraCombatLogTests;
+
+	const FString Filename = FPaths::CreateTempFilename(*FPaths::AutomationTransientDir(), TEXT("CombatLog"), TEXT(".hclog"));
+
+	TArray<FCombatLogEvent> Written;
+	Written.Reserve(kNumEvents);
+	for (int32 i = 0; i < kNumEvents; i++)
+	{
+		FCombatLogEvent Event;
+		Event.Type = static_cast<ECombatLogEventType>(i % 3);
+		Event.Frame = static_cast<uint32>(i);
+		Event.Time = i * 0.01f;
+		Event.SourceId = 1 + i % kNumActors;
+		Event.TargetId = 1 + (i + 1) % kNumActors;
+		Event.UnmitigatedAmount = static_cast<float>(i);
+		Event.FinalAmount = i * 0.5f;
+		Written.Add(Event);
+	}
+
+	uint32 DroppedCount = 0;
+	{
+		// Big enough that the ring never fills, the writer is destroyed before reading to finish the file
+		FCombatLogWriter Writer(Filename, kNumEvents);
+		for (int32 ActorId = 1; ActorId <= kNumActors; ActorId++)
+		{
+			Writer.AddName(ActorId, FString::Printf(TEXT("Actor_%d"), ActorId));
+		}
+		for (const FCombatLogEvent& Event : Written)
+		{
+			Writer.Log(Event);
+		}
+		DroppedCount = Writer.GetDroppedCount();
+	}
+
+	FCombatLogFile File;
+	const bool IsRead = FCombatLogReader::ReadFile(Filename, File);
+	IFileManager::Get().Delete(*Filename);
+
+	TestTrue(TEXT("Log file is readable"), IsRead);
+	TestEqual(TEXT("Dropped events"), DroppedCount, 0u);
+	if (!TestEqual(TEXT("Number of events"), File.Events.Num(), Written.Num()))
+	{
+		return false;
+	}
+
+	for (int32 i = 0; i < Written.Num(); i++)
+	{
+		if (FMemory::Memcmp(&File.Events[i], &Written[i], sizeof(FCombatLogEvent)) != 0)
+		{
+			AddError(FString::Printf(TEXT("Event %d doesn't match what was written"), i));
+			return false;
+		}
+	}
+
+	TestEqual(TEXT("Number of names"), File.Names.Num(), kNumActors);
+	for (int32 ActorId = 1; ActorId <= kNumActors; ActorId++)
+	{
+		TestEqual(TEXT("Actor name"), File.GetName(ActorId), FString::Printf(TEXT("Actor_%d"), ActorId));
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,95 @@
+// Copyright Final Fall Games. All Rights Reserved.
+
+#include "benchmark_utils.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "core/actors/base_character_actor.h"
+#include "core/gas/base_asc.h"
+#include "core/gas/life_attribute_set.h"
+
+#include "HAL/IConsoleManager.h"
+
+namespace HeraDamageTests
+{
+	constexpr auto kTestFlags = EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter;
+
+	constexpr int32 kNumHits = 5;
+	constexpr float kHitDamage = 20.0f;
+	constexpr float kHealth = 100.0f;
+	constexpr float kArmor = 50.0f;
+
+	/// Armor mitigates half of the damage it takes: four hits deal 10 each and use up 40 armor, the fifth meets
+	/// the last 10 armor and deals 5 + 10.
+	constexpr float kExpectedHealth = 95.0f;
+	constexpr float kExpectedArmor = 0.0f;
+
+	static ACharacterBase* SpawnCharacter(UWorld* World, const FVector& Location)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		auto Character = World->SpawnActor<ACharacterBase>(ACharacterBase::StaticClass(), Location, FRotator::ZeroRotator, SpawnParams);
+		if (!Character)
+		{
+			return nullptr;
+		}
+
+		auto ASC = Character->GetAbilitySystemComponent();
+		ASC->InitAbilityActorInfo(Character, Character);
+		ASC->SetNumericAttributeBase(ULifeAttributeSet::GetMaxHealthAttribute(), kHealth);
+		ASC->SetNumericAttributeBase(ULifeAttributeSet::GetHealthAttribute(), kHealth);
+		ASC->SetNumericAttributeBase(ULifeAttributeSet::GetMaxArmorAttribute(), kArmor);
+		ASC->SetNumericAttributeBase(ULifeAttributeSet::GetArmorAttribute(), kArmor);
+		return Character;
+	}
+}
+
+/// Hits coalesced into one commit per frame are mitigated like hits committed one by one.
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHeraCoalescedDamageTest, "Hera.Damage.CoalescedMitigation", HeraDamageTests::kTestFlags)
+bool FHeraCoalescedDamageTest::RunTest(const FString& Parameters)
+{
+	using namespace HeraDamageTests;
+
+	const auto Coalesce = IConsoleManager::Get().FindConsoleVariable(TEXT("Hera.Damage.Coalesce"));
+	if (!Coalesce)
+	{
+		AddError(TEXT("Hera.Damage.Coalesce is missing"));
+		return false;
+	}
+	const int32 OriginalCoalesce = Coalesce->GetInt();
+
+	for (int32 Mode = 0; Mode <= 1; ++Mode)
+	{
+		Coalesce->Set(Mode, ECVF_SetByCode);
+		const TCHAR* ModeName = Mode ? TEXT("coalesced") : TEXT("committed per hit");
+
+		FHeraBenchmarkWorld World;
+		const auto Source = SpawnCharacter(World.Get(), FVector(0.0f, 0.0f, 100.0f));
+		const auto Target = SpawnCharacter(World.Get(), FVector(500.0f, 0.0f, 100.0f));
+		if (!Source || !Target)
+		{
+			AddError(TEXT("Characters didn't spawn"));
+			break;
+		}
+
+		const auto SourceASC = Cast<UAbilitySystemComponentBase>(Source->GetAbilitySystemComponent());
+		const auto TargetASC = Cast<UAbilitySystemComponentBase>(Target->GetAbilitySystemComponent());
+		for (int32 Hit = 0; Hit < kNumHits; ++Hit)
+		{
+			TargetASC->ApplyDirectDamage(SourceASC, kHitDamage);
+		}
+
+		// Coalesced damage is committed on the next tick
+		World.Tick();
+		World.Tick();
+
+		TestEqual(*FString::Printf(TEXT("Health, %s"), ModeName), Target->GetHealth(), kExpectedHealth, KINDA_SMALL_NUMBER);
+		TestEqual(*FString::Printf(TEXT("Armor, %s"), ModeName), Target->GetArmor(), kExpectedArmor, KINDA_SMALL_NUMBER);
+	}
+
+	Coalesce->Set(OriginalCoalesce, ECVF_SetByCode);
+	return !HasAnyErrors();
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,110 @@
+// Copyright Final Fall Games. All Rights Reserved.
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "core/components/weapon_component.h"
+
+#include "Misc/AutomationTest.h"
+
+namespace HeraFireSchedulerTests
+{
+	constexpr auto kTestFlags = EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter;
+
+	constexpr double kShotInterval = 0.1;
+
+	/// Check the shot times a call to Advance returned.
+	static void TestShotTimes(FAutomationTestBase& Test, const TCHAR* What, const TArray<double>& Actual, const TArray<double>& Expected)
+	{
+		if (!Test.TestEqual(*FString::Printf(TEXT("%s: number of shots"), What), Actual.Num(), Expected.Num()))
+		{
+			return;
+		}
+
+		for (int32 Index = 0; Index < Expected.Num(); ++Index)
+		{
+			Test.TestEqual(*FString::Printf(TEXT("%s: time of shot %d"), What, Index), Actual[Index], Expected[Index], 1e-9);
+		}
+	}
+}
+
+/// Shots land on their own times between frames, however the frames fall.
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHeraFireSchedulerSubFrameTest, "Hera.Weapon.FireScheduler.SubFrame", HeraFireSchedulerTests::kTestFlags)
+bool FHeraFireSchedulerSubFrameTest::RunTest(const FString& Parameters)
+{
+	using namespace HeraFireSchedulerTests;
+
+	FFireScheduler Scheduler;
+	Scheduler.ShotInterval = kShotInterval;
+	TArray<double> ShotTimes;
+
+	Scheduler.PressTrigger(1.0);
+	Scheduler.Advance(1.25, 10, ShotTimes);
+	TestShotTimes(*this, TEXT("First frame"), ShotTimes, { 1.0, 1.1, 1.2 });
+
+	Scheduler.Advance(1.29, 10, ShotTimes);
+	TestShotTimes(*this, TEXT("Frame before the next shot"), ShotTimes, {});
+
+	Scheduler.Advance(1.31, 10, ShotTimes);
+	TestShotTimes(*this, TEXT("Frame after the next shot"), ShotTimes, { 1.3 });
+
+	Scheduler.ReleaseTrigger();
+	Scheduler.Advance(2.0, 10, ShotTimes);
+	TestShotTimes(*this, TEXT("Released"), ShotTimes, {});
+
+	return true;
+}
+
+/// A long frame fires at most MaxShots, the newest ones, and the shots after it keep the rate.
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHeraFireSchedulerCatchUpTest, "Hera.Weapon.FireScheduler.CatchUp", HeraFireSchedulerTests::kTestFlags)
+bool FHeraFireSchedulerCatchUpTest::RunTest(const FString& Parameters)
+{
+	using namespace HeraFireSchedulerTests;
+
+	FFireScheduler Scheduler;
+	Scheduler.ShotInterval = kShotInterval;
+	TArray<double> ShotTimes;
+
+	Scheduler.PressTrigger(0.0);
+	Scheduler.Advance(1.05, 3, ShotTimes);
+	TestShotTimes(*this, TEXT("Hitch"), ShotTimes, { 0.8, 0.9, 1.0 });
+	TestEqual(TEXT("Next shot after the hitch"), Scheduler.NextShotTime, 1.1, 1e-9);
+
+	Scheduler.Advance(1.15, 3, ShotTimes);
+	TestShotTimes(*this, TEXT("Frame after the hitch"), ShotTimes, { 1.1 });
+
+	return true;
+}
+
+/// Pressing the trigger faster than the fire rate doesn't fire faster than it.
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHeraFireSchedulerTapTest, "Hera.Weapon.FireScheduler.Tap", HeraFireSchedulerTests::kTestFlags)
+bool FHeraFireSchedulerTapTest::RunTest(const FString& Parameters)
+{
+	using namespace HeraFireSchedulerTests;
+
+	FFireScheduler Scheduler;
+	Scheduler.ShotInterval = kShotInterval;
+	TArray<double> ShotTimes;
+
+	Scheduler.PressTrigger(0.0);
+	Scheduler.Advance(0.0, 10, ShotTimes);
+	TestShotTimes(*this, TEXT("First tap"), ShotTimes, { 0.0 });
+	Scheduler.ReleaseTrigger();
+
+	Scheduler.PressTrigger(0.02);
+	Scheduler.Advance(0.02, 10, ShotTimes);
+	TestShotTimes(*this, TEXT("Tap before the interval"), ShotTimes, {});
+	Scheduler.Advance(0.1, 10, ShotTimes);
+	TestShotTimes(*this, TEXT("Held until the interval"), ShotTimes, { 0.1 });
+	Scheduler.ReleaseTrigger();
+
+	// Long after the last shot the next tap fires right away
+	Scheduler.PressTrigger(5.0);
+	Scheduler.Advance(5.0, 10, ShotTimes);
+	TestShotTimes(*this, TEXT("Tap after a pause"), ShotTimes, { 5.0 });
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,105 @@
+// Copyright Final Fall Games. All Rights Reserved.
+
+#include "core/ui/healthbar_overlay.h"
+#include "core/hera_stats.h"
+
+#include "Rendering/DrawElements.h"
+#include "Styling/CoreStyle.h"
+
+DECLARE_CYCLE_STAT(TEXT("HealthbarOverlayPaint"), STAT_Hera_HealthbarOverlayPaint, STATGROUP_Hera);
+
+/// Size of a bar at scale 1, in slate units.
+static constexpr float kBarWidth = 80.0f;
+static constexpr float kBarHeight = 8.0f;
+
+/// Dark outline around the segments.
+static constexpr float kBarBorder = 1.0f;
+
+static const FLinearColor kBackgroundColor(0.0f, 0.0f, 0.0f, 0.6f);
+static const FLinearColor kHealthColor(0.85f, 0.85f, 0.85f);
+static const FLinearColor kArmorColor(0.95f, 0.6f, 0.1f);
+static const FLinearColor kShieldsColor(0.2f, 0.55f, 1.0f);
+static const FLinearColor kOverHealthColor(0.3f, 0.95f, 0.4f);
+static const FLinearColor kOverArmorColor(1.0f, 0.85f, 0.3f);
+
+void SHealthbarOverlay::Construct(const FArguments& InArgs)
+{
+	Brush = FCoreStyle::Get().GetBrush("GenericWhiteBox");
+	SetVisibility(EVisibility::HitTestInvisible);
+	SetCanTick(false);
+}
+
+void SHealthbarOverlay::SetHealthbars(TArray<FHealthbarDrawData>&& NewHealthbars)
+{
+	Healthbars = MoveTemp(NewHealthbars);
+	Invalidate(EInvalidateWidgetReason::Paint);
+}
+
+FVector2D SHealthbarOverlay::ComputeDesiredSize(float LayoutScaleMultiplier) const
+{
+	return FVector2D::ZeroVector;
+}
+
+int32 SHealthbarOverlay::OnPaint(
+	const FPaintArgs& Args,
+	const FGeometry& AllottedGeometry,
+	const FSlateRect& MyCullingRect,
+	FSlateWindowElementList& OutDrawElements,
+	int32 LayerId,
+	const FWidgetStyle& InWidgetStyle,
+	bool bParentEnabled
+) const
+{
+	HERA_SCOPE_CYCLE_COUNTER(HealthbarOverlayPaint);
+
+	// Positions are in viewport pixels, geometry is in slate units
+	const float PixelsToLocal = AllottedGeometry.Scale > 0.0f ? 1.0f / AllottedGeometry.Scale : 1.0f;
+
+	const auto DrawBox = [&](const FVector2f& Offset, const FVector2f& Size, const FLinearColor& Color, int32 Layer)
+	{
+		FSlateDrawElement::MakeBox(
+			OutDrawElements,
+			Layer,
+			AllottedGeometry.ToPaintGeometry(FVector2D(Size), FSlateLayoutTransform(FVector2D(Offset))),
+			Brush,
+			ESlateDrawEffect::None,
+			Color * InWidgetStyle.GetColorAndOpacityTint()
+		);
+	};
+
+	// Every background on one layer and every segment on the next, so they batch into as few draws as possible
+	for (const auto& Healthbar : Healthbars)
+	{
+		const FVector2f Size = FVector2f(kBarWidth, kBarHeight) * Healthbar.Scale;
+		const FVector2f TopLeft = Healthbar.Position * PixelsToLocal - FVector2f(Size.X * 0.5f, Size.Y);
+		DrawBox(TopLeft - kBarBorder, Size + 2.0f * kBarBorder, kBackgroundColor, LayerId);
+
+		const float Amounts[] = {
+			Healthbar.Health, 
+			Healthbar.OverHealth, 
+			Healthbar.Armor, 
+			Healthbar.OverArmor, 
+			Healthbar.Shields
+		};
+		const FLinearColor* Colors[] = {
+			&kHealthColor, 
+			&kOverHealthColor, 
+			&kArmorColor, 
+			&kOverArmorColor, 
+			&kShieldsColor
+		};
+
+		float Filled = 0.0f;
+		for (int32 Segment = 0; Segment < UE_ARRAY_COUNT(Amounts); ++Segment)
+		{
+			const float Width = FMath::Min(Amounts[Segment], 1.0f - Filled) * Size.X;
+			if (Width > 0.0f)
+			{
+				DrawBox(TopLeft + FVector2f(Filled * Size.X, 0.0f), FVector2f(Width, Size.Y), *Colors[Segment], LayerId + 1);
+				Filled += Amounts[Segment];
+			}
+		}
+	}
+
+	return LayerId + 1;
+}
@@ -4,12 +4,37 @@
 #include "core/actors/base_character_actor.h"
 
 
+FHealthbarSnapshot FHealthbarSnapshot::FromCharacter(const ACharacterBase* Character)
+{
+   FHealthbarSnapshot Snapshot;
+   if (Character)
+   {
+      Snapshot.Health =     Character->GetHealth();
+      Snapshot.MaxHealth =  Character->GetMaxHealth();
+      Snapshot.Shields =    Character->GetShields();
+      Snapshot.MaxShields = Character->GetMaxShields();
+      Snapshot.Armor =      Character->GetArmor();
+      Snapshot.MaxArmor =   Character->GetMaxArmor();
+      Snapshot.OverHealth = Character->GetOverHealth();
+      Snapshot.OverArmor =  Character->GetOverArmor();
+   }
+   return Snapshot;
+}
+
 void UHealthbarWidget::SetOwningCharacter(ACharacterBase* NewOwningCharacter)
 {
-   OwningCharacter =  NewOwningCharacter; 
-   SetCurrentHealth(  OwningCharacter->GetHealth());
-   SetCurrentShields( OwningCharacter->GetShields());
-   SetCurrentArmor(   OwningCharacter->GetArmor());
-   SetOverHealth(     OwningCharacter->GetOverHealth());
-   SetOverArmor(      OwningCharacter->GetOverArmor());
+   OwningCharacter = NewOwningCharacter; 
+   ApplySnapshot(FHealthbarSnapshot::FromCharacter(OwningCharacter));
+}
+
+void UHealthbarWidget::ApplySnapshot_Implementation(const FHealthbarSnapshot& Snapshot)
+{
+   SetMaxHealth(      Snapshot.MaxHealth);
+   SetCurrentHealth(  Snapshot.Health);
+   SetMaxShields(     Snapshot.MaxShields);
+   SetCurrentShields( Snapshot.Shields);
+   SetMaxArmor(       Snapshot.MaxArmor);
+   SetCurrentArmor(   Snapshot.Armor);
+   SetOverHealth(     Snapshot.OverHealth);
+   SetOverArmor(      Snapshot.OverArmor);
 }
\ No newline at end of file
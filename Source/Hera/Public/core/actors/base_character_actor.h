@@ -7,6 +7,12 @@
 #include "InputActionValue.h"
 #include "AbilitySystemInterface.h"
 #include "AbilitySystemComponent.h"
+#include "GameplayCueInterface.h"
+#include "core/subsystems/lag_compensation_subsystem.h"
+#include "core/subsystems/projectile_sim_subsystem.h"
+#include "core/subsystems/significance_subsystem.h"
+#include "core/components/weapon_component.h"
+#include "core/ui/healthbar_widget.h"
 #include "base_character_actor.generated.h"
 
 class UInputComponent;
@@ -17,9 +23,10 @@ class USpringArmComponent;
 class UAnimMontage;
 class USoundBase;
 class UAbilityBase;
+struct FStreamableHandle;
 
 UCLASS(config=Game)
-class HERA_API ACharacterBase : public ACharacter, public IAbilitySystemInterface
+class HERA_API ACharacterBase : public ACharacter, public IAbilitySystemInterface, public IGameplayCueInterface
 {
 	GENERATED_BODY()
 
@@ -32,6 +39,14 @@ public:
 	// It should return a reference to this OwningActor's AbilitySystemComponent 
 	virtual class UAbilitySystemComponent* GetAbilitySystemComponent() const override;
 
+	// Weapon fire cues go to UCosmeticFeedbackSubsystem, everything else to the cue's notifies as usual
+	virtual void HandleGameplayCue(
+		AActor* Self, 
+		FGameplayTag GameplayCueTag, 
+		EGameplayCueEvent::Type EventType, 
+		const FGameplayCueParameters& Parameters
+	) override;
+
 	virtual void InitializeAttributes();
 
 	// Grants the abilities set in the DefaultAbilities property to the Character when that
@@ -112,7 +127,15 @@ private:
 	//------------------------------------------------------------------------------------------------------------------
 
 public:
-	ACharacterBase();
+	ACharacterBase(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+
+	/// Names of the cosmetic components, which a dedicated server doesn't create. Subclasses can leave them out
+	/// elsewhere too with FObjectInitializer::DoNotCreateDefaultSubobject.
+	static const FName kFirstPersonCameraName;
+	static const FName kThirdPersonCameraBoomName;
+	static const FName kThirdPersonCameraName;
+	static const FName kMesh1PName;
+	static const FName kFloatingHealthbarName;
 
 	virtual void Landed(const FHitResult& Hit) override;
 
@@ -133,6 +156,11 @@ public:
 	UFUNCTION(BlueprintCallable, Category ="Hera|Character|Weapon")
 	bool GetHasRifle();
 
+	// Parts of the mesh that lag compensated hits tell apart from the body, e.g. the head.
+	// Only the first kLagCompensationMaxHitZones are recorded.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category ="Hera|Character|Hit Zones")
+	TArray<FLagCompensationHitZone> HitZones;
+
 	UFUNCTION(BlueprintCallable, Category ="Hera|Character|Camera")
 	void SetCameraIsChangingPov(bool bNewIsChanging);
 
@@ -145,13 +173,23 @@ public:
 	UFUNCTION(BlueprintCallable, Category ="Hera|Character|Camera")
 	void SetCameraToTPV();
 
+	/// Null on a dedicated server, which doesn't create cosmetic components.
 	UFUNCTION(BlueprintCallable, Category ="Hera|Character")
 	USkeletalMeshComponent* GetMesh1P() const { return Mesh1P; }
 
+	/// Null on a dedicated server. Aim through GetAimViewPoint, which works either way.
 	UCameraComponent* GetFirstPersonCameraComponent() const { return FirstPersonCameraComponent; }
 	
+	/// Null on a dedicated server.
 	UCameraComponent* GetThirdPersonCameraComponent() const { return ThirdPersonCameraComponent; }
 
+	/// Where the character aims from and towards: the first person camera, or where it would be without one.
+	UFUNCTION(BlueprintCallable, Category ="Hera|Character|Camera")
+	void GetAimViewPoint(FVector& OutLocation, FRotator& OutRotation) const;
+
+	/// What a held weapon attaches to: the first person mesh, or the body without one.
+	USceneComponent* GetWeaponAttachParent() const;
+
 private:
 	// Pawn mesh: 1st person view (arms; seen only by self)
 	UPROPERTY(VisibleDefaultsOnly, Category=Mesh)
@@ -208,6 +246,8 @@ private:
 protected:
 	virtual void BeginPlay();
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	void Move(const FInputActionValue& Value);
 
 	void Look(const FInputActionValue& Value);
@@ -218,6 +258,44 @@ protected:
 	UFUNCTION(BlueprintCallable, Category="Hera|Character|Input")
 	void UnDuck(const FInputActionValue& Value);
 
+	//------------------------------------------------------------------------------------------------------------------
+	/// MARK: - Weapon
+	//------------------------------------------------------------------------------------------------------------------
+
+public:
+	// Sent by the server with the batched projectiles this character fired in a frame. Clients other than the
+	// shooter, who already fired their own, fly copies in UProjectileSimSubsystem. Unreliable because the copies
+	// are only visuals, the server's projectiles apply the hits.
+	UFUNCTION(NetMulticast, Unreliable)
+	void MulticastProjectilesSpawned(const TArray<FProjectileSpawnEvent>& Events);
+
+	// All the shots the equipped weapon fired in a frame on the owning client
+	UFUNCTION(Server, Reliable)
+	void ServerFireWeapon(const FWeaponShotBatch& Batch);
+
+	void SetEquippedWeapon(UTP_WeaponComponent* Weapon) { EquippedWeapon = Weapon; }
+
+	UTP_WeaponComponent* GetEquippedWeapon() const { return EquippedWeapon; }
+
+private:
+	UPROPERTY()
+	TObjectPtr<UTP_WeaponComponent> EquippedWeapon;
+
+	//------------------------------------------------------------------------------------------------------------------
+	/// MARK: - Significance
+	//------------------------------------------------------------------------------------------------------------------
+
+public:
+	/// Apply the FSignificanceBudget of NewSignificance: actor tick, animation, healthbar and fire feedback rates.
+	/// Set by USignificanceSubsystem.
+	void SetSignificance(ESignificance NewSignificance);
+
+	UFUNCTION(BlueprintPure, Category ="Hera|Character")
+	ESignificance GetSignificance() const { return Significance; }
+
+private:
+	ESignificance Significance = ESignificance::Critical;
+
 	//------------------------------------------------------------------------------------------------------------------
 	/// MARK: - UI
 	//------------------------------------------------------------------------------------------------------------------
@@ -226,12 +304,38 @@ public:
 	/// The healthbar that floats over characters' heads
 	class UHealthbarWidget* GetFloatingHealthbar();
 
+	/// Null until the class is loaded.
+	TSubclassOf<UHealthbarWidget> GetHealthbarWidgetClass() const { return HealthbarWidgetClass.Get(); }
+
+	const TSoftClassPtr<UHealthbarWidget>& GetHealthbarWidgetSoftClass() const { return HealthbarWidgetClass; }
+
+	/// The life pool as the healthbar last showed it.
+	const FHealthbarSnapshot& GetHealthbarSnapshot() const { return HealthbarSnapshot; }
+
+	/// Show Snapshot on the healthbar. Called by UHealthbarSubsystem when it flushes a changed life pool.
+	void SetHealthbarSnapshot(const FHealthbarSnapshot& Snapshot);
+
 protected:
 	UFUNCTION()
 	void InitializeFloatingHealthbar();
 
+	/// Mark the healthbar dirty in UHealthbarSubsystem whenever a life attribute changes.
+	void BindLifeAttributes();
+
+	void UnbindLifeAttributes();
+
+	void OnLifeAttributeChanged(const FOnAttributeChangeData& Data);
+
+	FHealthbarSnapshot HealthbarSnapshot;
+
+	bool IsLifeAttributesBound = false;
+
+	/// Loaded on demand the first time a healthbar widget is needed, so never on a dedicated server.
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Hera|UI")
-	TSubclassOf<class UHealthbarWidget> HealthbarWidgetClass;
+	TSoftClassPtr<class UHealthbarWidget> HealthbarWidgetClass;
+
+	/// Keeps HealthbarWidgetClass loaded while this character has a healthbar.
+	TSharedPtr<FStreamableHandle> HealthbarWidgetClassHandle;
 
 	UPROPERTY()
 	class UHealthbarWidget* FloatingHealthbarWidget;
@@ -5,8 +5,38 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "GameplayEffect.h"
+#include "Engine/NetSerialization.h"
 #include "projectile_actor.generated.h"
 
+class UProjectilePoolSubsystem;
+
+/// Replicated launch state of a pooled projectile. Pooled projectiles are never destroyed, so clients learn about
+/// every reuse through this instead of through a new actor channel.
+USTRUCT()
+struct FProjectilePoolState
+{
+	GENERATED_BODY()
+
+	/// Where the projectile was launched from.
+	UPROPERTY()
+	FVector_NetQuantize10 Location;
+
+	/// Direction it was launched in.
+	UPROPERTY()
+	FVector_NetQuantizeNormal Direction;
+
+	/// Bumped on every launch so a relaunch replicates even if the projectile never went inactive in between.
+	UPROPERTY()
+	uint8 LaunchCount = 0;
+
+	UPROPERTY()
+	bool IsActive = false;
+
+	/// Set once when the pool spawns the projectile. Clients can't tell from LaunchCount, which wraps.
+	UPROPERTY()
+	bool IsPooled = false;
+};
+
 UCLASS()
 class HERA_API AProjectileBase : public AActor
 {
@@ -16,11 +46,72 @@ public:
 	// Sets default values for this actor's properties
 	AProjectileBase();
 
+	/// Applied to whatever the projectile hits. Usually the firing weapon's damage spec, shared by all its shots.
 	UPROPERTY(BlueprintReadWrite, Meta = (ExposeOnSpawn = true))
 	FGameplayEffectSpecHandle EffectSpecHandle;
 
 	UPROPERTY(BlueprintReadOnly, VisibleAnywhere)
 	class UProjectileMovementComponent* ProjectileMovement;
+
+	/// Fly this projectile in UProjectileSimSubsystem instead of as an actor with its own movement and collision.
+	/// The class is then only spawned as a visual where something renders. Leave it off for projectiles that
+	/// need their own behaviour, like bouncing or homing.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Projectile")
+	bool UseBatchedSimulation = false;
+
+	/// Done with this projectile, after a hit or when its lifespan runs out. Pooled projectiles go back to
+	/// UProjectilePoolSubsystem, others are destroyed.
+	UFUNCTION(BlueprintCallable, Category="Projectile")
+	void Release();
+
+	/// Whether this projectile belongs to a UProjectilePoolSubsystem.
+	bool IsPooled() const { return Pool.IsValid() || PoolState.IsPooled; }
+
+	/// Whether the projectile is flying. Pooled projectiles sitting in their pool are hidden and don't collide.
+	bool IsInPlay() const { return InPlay; }
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+protected:
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/// Pooled projectiles are released instead of destroyed.
+	virtual void LifeSpanExpired() override;
+
+	UFUNCTION()
+	void OnRep_PoolState();
+
+	UPROPERTY(ReplicatedUsing = OnRep_PoolState)
+	FProjectilePoolState PoolState;
+
+private:
+	friend class UProjectilePoolSubsystem;
+	friend class UProjectileSimSubsystem;
+
+	/// Authority only. Put a pooled projectile in flight and tell clients about it.
+	void Launch(const FVector& Location, const FRotator& Rotation);
+
+	/// Authority only. Take a pooled projectile out of play and let it go dormant.
+	void Retire();
+
+	/// Show it, turn collision on and restart the movement from Location.
+	void EnterPlay(const FVector& Location, const FRotator& Rotation);
+
+	/// Hide it, turn collision off and stop the movement.
+	void LeavePlay();
+
+	/// Keeps the projectiles alive stat in sync with InPlay.
+	void SetInPlay(bool NewInPlay);
+
+	/// The pool this projectile came from and goes back to. Only set where the projectile was spawned.
+	TWeakObjectPtr<UProjectilePoolSubsystem> Pool;
+
+	bool InPlay = false;
+
+	/// Only shows a projectile simulated by UProjectileSimSubsystem. It never moves or collides on its own.
+	bool IsVisualOnly = false;
 };
 
 UCLASS(config=Game)
@@ -50,7 +141,9 @@ public:
 	/// Returns ProjectileMovement Component
 	// UProjectileMovementComponent* GetProjectileMovement() const { return ProjectileMovement; }
 
+	/// Damage per hit. Weapons firing this class use it as their damage, through their damage spec's SetByCaller
+	/// magnitude, or directly when they have no damage effect.
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Health")
-	int damage;
+	float Damage;
 };
 
@@ -4,9 +4,73 @@
 
 #include "CoreMinimal.h"
 #include "Components/SkeletalMeshComponent.h"
+#include "GameplayEffectTypes.h"
+#include "Engine/NetSerialization.h"
 #include "weapon_component.generated.h"
 
 class ACharacterBase;
+class UGameplayEffect;
+class UWeaponDefinition;
+struct FStreamableHandle;
+
+UENUM(BlueprintType)
+enum class EWeaponFireMode : uint8
+{
+	/// Fires ProjectileClass from the muzzle.
+	Projectile,
+
+	/// Traces from the camera through UHitscanSubsystem. Doesn't need a ProjectileClass.
+	Hitscan,
+};
+
+/// The shots one weapon fired in one frame, sent to the server in a single RPC.
+USTRUCT()
+struct HERA_API FWeaponShotBatch
+{
+	GENERATED_BODY()
+
+	/// Where the shooter looked from when the frame's shots fired.
+	UPROPERTY()
+	FVector_NetQuantize10 ViewLocation;
+
+	UPROPERTY()
+	FVector_NetQuantizeNormal AimDirection;
+
+	/// The shooter's AGameStateBase::GetServerWorldTimeSeconds for the frame.
+	UPROPERTY()
+	float ServerTime = 0.0f;
+
+	/// ShotCount of the first shot, so every machine seeds the shots the same.
+	UPROPERTY()
+	int32 FirstShot = 0;
+
+	/// How long before ServerTime each shot fired, oldest first, in 0.1 ms.
+	UPROPERTY()
+	TArray<uint16> ShotAges;
+
+	/// Seconds before ServerTime shot Index fired.
+	float GetShotAge(int32 Index) const { return ShotAges[Index] / 10000.0f; }
+};
+
+/// Turns a rate of fire into shot times that don't depend on the frame rate.
+struct HERA_API FFireScheduler
+{
+	/// Seconds between shots.
+	double ShotInterval = 0.1;
+
+	/// When the next shot is due. Stays ahead after the trigger is released, so tapping can't beat the rate.
+	double NextShotTime = 0.0;
+
+	bool IsTriggerHeld = false;
+
+	void PressTrigger(double Now);
+
+	void ReleaseTrigger();
+
+	/// Times of the shots due by Now, oldest first. After a long frame only the newest MaxShots are kept and the
+	/// others are skipped.
+	void Advance(double Now, int32 MaxShots, TArray<double>& OutShotTimes);
+};
 
 UCLASS(Blueprintable, BlueprintType, ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
 class HERA_API UTP_WeaponComponent : public USkeletalMeshComponent
@@ -14,6 +78,44 @@ class HERA_API UTP_WeaponComponent : public USkeletalMeshComponent
 	GENERATED_BODY()
 
 public:
+	/** Where everything below comes from when set, streamed in through the asset manager. Leave the asset
+	 *  references below empty then, so they don't load with the weapon. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Gameplay)
+	TObjectPtr<UWeaponDefinition> Definition;
+
+	/** How a shot reaches its target */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Gameplay)
+	EWeaponFireMode FireMode = EWeaponFireMode::Projectile;
+
+	/** Length of a hitscan trace in cm */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Hitscan, meta=(EditCondition="FireMode == EWeaponFireMode::Hitscan"))
+	float HitscanRange = 10000.0f;
+
+	/** Traces per hitscan shot, more than 1 for shotguns */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Hitscan, meta=(ClampMin=1, EditCondition="FireMode == EWeaponFireMode::Hitscan"))
+	int32 PelletCount = 1;
+
+	/** Half angle of the cone the pellets spread over, in degrees */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Hitscan, meta=(ClampMin=0, EditCondition="FireMode == EWeaponFireMode::Hitscan"))
+	float PelletSpreadDegrees = 0.0f;
+
+	/** Shots per minute while the trigger is held */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Gameplay, meta=(ClampMin=1))
+	float RoundsPerMinute = 600.0f;
+
+	/** Most shots fired in one frame. A longer hitch skips the rest instead of firing them all at once */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Gameplay, meta=(ClampMin=1))
+	int32 MaxShotsPerFrame = 3;
+
+	/** Damage per pellet that hits */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Hitscan, meta=(EditCondition="FireMode == EWeaponFireMode::Hitscan"))
+	float HitscanDamage = 10.0f;
+
+	/** GameplayEffect every hit applies, with the damage as its Effect.Damage SetByCaller magnitude. Without one,
+	 *  hits apply the damage directly through UAbilitySystemComponentBase::ApplyDirectDamage. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category=Gameplay)
+	TSubclassOf<UGameplayEffect> DamageEffectClass;
+
 	/** Projectile class to spawn */
 	UPROPERTY(EditDefaultsOnly, Category=Projectile)
 	TSubclassOf<class AHeraProjectile> ProjectileClass;
@@ -49,7 +151,33 @@ public:
 	UFUNCTION(BlueprintCallable, Category="Weapon")
 	void Fire();
 
+	/** Fire at RoundsPerMinute until StopFiring. Locally controlled characters only */
+	UFUNCTION(BlueprintCallable, Category="Weapon")
+	void StartFiring();
+
+	UFUNCTION(BlueprintCallable, Category="Weapon")
+	void StopFiring();
+
+	/** Server only. Fire the shots a client sent, minus any that come faster than RoundsPerMinute allows */
+	void FireBatchFromClient(const FWeaponShotBatch& Batch);
+
+	/** Play the fire sound and animation for NumShots shots through the GameplayCue.Weapon.Fire cue. Local only,
+	 *  UCosmeticFeedbackSubsystem coalesces it with anything identical in the same frame */
+	void ExecuteFireCue(int32 NumShots);
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	/** Damage of every hit from now on. With a DamageEffectClass that includes projectiles already in flight,
+	 *  which share the weapon's damage spec. */
+	UFUNCTION(BlueprintCallable, Category="Weapon")
+	void SetDamage(float NewDamage);
+
+	UFUNCTION(BlueprintPure, Category="Weapon")
+	float GetDamage() const { return Damage; }
+
 protected:
+	virtual void BeginPlay() override;
+
 	/** Ends gameplay for this component. */
 	UFUNCTION()
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
@@ -57,4 +185,56 @@ protected:
 private:
 	/** The Character holding this weapon*/
 	ACharacterBase* Character;
+
+	/** Shots fired since the weapon was created. Seeds the pellet pattern. */
+	int32 ShotCount = 0;
+
+	/** The part of equipping that needs the weapon's assets: damage spec, projectile pool and input */
+	void FinishEquip();
+
+	void BindFireInput();
+
+	/** Copy the plain values of Definition, which don't need loading */
+	void ApplyDefinitionSettings();
+
+	/** Stream in Definition's Gameplay bundle, and its Client bundle too when WithClientAssets */
+	void LoadDefinition(bool WithClientAssets);
+
+	void OnDefinitionLoaded();
+
+	/** Keeps Definition's bundles loaded while the weapon exists */
+	TSharedPtr<FStreamableHandle> DefinitionHandle;
+
+	bool IsFireInputBound = false;
+
+	/** Fire the shots FireScheduler has due this frame */
+	void UpdateFiring();
+
+	/** Fire shots at the given local times, here and on the server */
+	void FireShots(const TArray<double>& ShotTimes);
+
+	/** Aim and time shots fired at ShotTimes from where the player is looking now */
+	bool MakeBatch(const TArray<double>& ShotTimes, FWeaponShotBatch& OutBatch) const;
+
+	/** Fire a frame's shots as one hitscan or projectile submission, with one sound and animation */
+	void FireBatch(const FWeaponShotBatch& Batch);
+
+	FFireScheduler FireScheduler;
+
+	/** Reused by UpdateFiring */
+	TArray<double> DueShotTimes;
+
+	/** Server time of the last shot accepted from the client */
+	float LastAcceptedShotTime = -FLT_MAX;
+
+	/** Build DamageSpec from DamageEffectClass. Only where damage is applied. */
+	void BuildDamageSpec();
+
+	/** Made once when the weapon is equipped and shared by every shot and projectile, so firing never makes a
+	 *  spec or an effect context. Only its SetByCaller damage changes afterwards. Whatever the effect snapshots
+	 *  from the wielder is captured on equip. */
+	FGameplayEffectSpecHandle DamageSpec;
+
+	/** Damage per hit. HitscanDamage or the projectile's Damage until SetDamage. */
+	float Damage = 0.0f;
 };
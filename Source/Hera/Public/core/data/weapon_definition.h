@@ -0,0 +1,84 @@
+// Copyright Final Fall Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "core/components/weapon_component.h"
+#include "weapon_definition.generated.h"
+
+class AHeraProjectile;
+class UAnimMontage;
+class UGameplayEffect;
+class UInputAction;
+class UInputMappingContext;
+class USoundBase;
+
+/// Everything about a weapon that isn't its mesh. Assets are soft references in two asset bundles:
+///  - Gameplay: what firing needs. Loaded everywhere, when the weapon spawns.
+///  - Client: sounds, animations and input. Loaded on pickup and never on a dedicated server.
+///
+/// NOTES:
+// - Found by the asset manager under /Game/Hera/Data through PrimaryAssetTypesToScan in DefaultGame.ini.
+UCLASS(BlueprintType)
+class HERA_API UWeaponDefinition : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	static const FPrimaryAssetType kPrimaryAssetType;
+	static const FName kGameplayBundle;
+	static const FName kClientBundle;
+
+	virtual FPrimaryAssetId GetPrimaryAssetId() const override;
+
+	//------------------------------------------------------------------------------------------------------------------
+	/// MARK: - Gameplay
+	//------------------------------------------------------------------------------------------------------------------
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category=Gameplay)
+	EWeaponFireMode FireMode = EWeaponFireMode::Projectile;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category=Gameplay, meta=(ClampMin=1))
+	float RoundsPerMinute = 600.0f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category=Gameplay, meta=(ClampMin=1))
+	int32 MaxShotsPerFrame = 3;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category=Gameplay, meta=(AssetBundles="Gameplay"))
+	TSoftClassPtr<UGameplayEffect> DamageEffectClass;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category=Hitscan, meta=(EditCondition="FireMode == EWeaponFireMode::Hitscan"))
+	float HitscanRange = 10000.0f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category=Hitscan, meta=(ClampMin=1, EditCondition="FireMode == EWeaponFireMode::Hitscan"))
+	int32 PelletCount = 1;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category=Hitscan, meta=(ClampMin=0, EditCondition="FireMode == EWeaponFireMode::Hitscan"))
+	float PelletSpreadDegrees = 0.0f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category=Hitscan, meta=(EditCondition="FireMode == EWeaponFireMode::Hitscan"))
+	float HitscanDamage = 10.0f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category=Projectile, meta=(AssetBundles="Gameplay", EditCondition="FireMode == EWeaponFireMode::Projectile"))
+	TSoftClassPtr<AHeraProjectile> ProjectileClass;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category=Projectile)
+	FVector MuzzleOffset = FVector(100.0f, 0.0f, 10.0f);
+
+	//------------------------------------------------------------------------------------------------------------------
+	/// MARK: - Client
+	//------------------------------------------------------------------------------------------------------------------
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category=Cosmetics, meta=(AssetBundles="Client"))
+	TSoftObjectPtr<USoundBase> FireSound;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category=Cosmetics, meta=(AssetBundles="Client"))
+	TSoftObjectPtr<UAnimMontage> FireAnimation;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category=Input, meta=(AssetBundles="Client"))
+	TSoftObjectPtr<UInputMappingContext> FireMappingContext;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category=Input, meta=(AssetBundles="Client"))
+	TSoftObjectPtr<UInputAction> FireAction;
+};
@@ -6,6 +6,8 @@
 #include "GameFramework/GameModeBase.h"
 #include "game_mode.generated.h"
 
+struct FStreamableHandle;
+
 UCLASS(minimalapi)
 class AHeraGameMode : public AGameModeBase
 {
@@ -13,6 +15,23 @@ class AHeraGameMode : public AGameModeBase
 
 public:
 	AHeraGameMode();
+
+	/// Starts loading the pawn class, so constructing the game mode loads nothing.
+	virtual void InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) override;
+
+	/// Waits for the pawn class if a player joins before it's loaded.
+	virtual UClass* GetDefaultPawnClassForController_Implementation(AController* InController) override;
+
+protected:
+	/// Becomes DefaultPawnClass once loaded, unless a subclass set DefaultPawnClass to something other than
+	/// the native ACharacterBase placeholder.
+	UPROPERTY(EditDefaultsOnly, Category = "Hera|Classes")
+	TSoftClassPtr<APawn> DefaultPawnSoftClass;
+
+private:
+	void OnDefaultPawnClassLoaded();
+
+	TSharedPtr<FStreamableHandle> DefaultPawnClassHandle;
 };
 
 
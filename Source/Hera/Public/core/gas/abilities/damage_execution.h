@@ -26,6 +26,10 @@ public:
 		OUT FGameplayEffectCustomExecutionOutput& OutExecutionOutput
 	) const override;
 
+	/// All Armor in the Health Pool will mitigate 50% of the incoming damage.
+	/// Shared with UAbilitySystemComponentBase::ApplyDirectDamage so both paths mitigate the same way.
+	static float MitigateDamage(float UnmitigatedDamage, float Armor, float OverArmor);
+
 protected:
 	float CritMultiplier;
 };
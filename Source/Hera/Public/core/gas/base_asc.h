@@ -50,4 +50,35 @@ public:
 		float UnmitigatedHealing, 
 		float FinalHealing
 	);
+
+	/// Server only. Damage this ASC from a trusted hit without building a GameplayEffectSpec, capturing attributes or
+	/// running UDamageExecution. Armor mitigation is the same as UDamageExecution, and the result goes through
+	/// DamageReceivedDelegate and ULifeAttributeSet the same way. Anything that needs full GameplayEffect semantics 
+	/// (buffs, debuffs, tags, cues) should keep applying a damage GameplayEffect.
+	/// Returns the final damage after mitigation.
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category="Hera|Damage")
+	float ApplyDirectDamage(UAbilitySystemComponentBase* SourceASC, float UnmitigatedDamage);
+
+	/// Server only. Damage from a hit that isn't a projectile actor, e.g. a batched projectile or a hitscan trace.
+	/// Applies EffectSpecHandle to the target's ASC when it's valid, otherwise ApplyDirectDamage with DirectDamage.
+	static void ApplyHitDamage(
+		AActor* TargetActor, 
+		AActor* SourceActor, 
+		const FGameplayEffectSpecHandle& EffectSpecHandle, 
+		float DirectDamage
+	);
+
+	/// Called from ULifeAttributeSet when this ASC defeats someone. Every bounty queued during a frame is 
+	/// granted with a single application of UBountyEffect on the next tick.
+	void QueueKillReward(float RewardXP);
+
+protected:
+	/// Grant the bounties queued by QueueKillReward.
+	void FlushKillRewards();
+
+	/// XP from kills this frame that hasn't been granted yet.
+	float PendingRewardXP = 0.0f;
+
+	/// Number of kills this frame that haven't been rewarded yet.
+	int32 PendingKillCount = 0;
 };
@@ -0,0 +1,26 @@
+// Copyright Final Fall Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayEffect.h"
+#include "bounty_effect.generated.h"
+
+class UAbilitySystemComponent;
+
+/// Instant effect granting the rewards for defeating a character.
+/// The amounts are SetByCaller magnitudes so the class default object can be applied for every kill without
+/// creating a new GameplayEffect.
+///  - HeraTags::Tag_BountyXP   : XP
+///  - HeraTags::Tag_BountyGold : Gold, once there is a Gold attribute
+UCLASS()
+class HERA_API UBountyEffect : public UGameplayEffect
+{
+	GENERATED_BODY()
+
+public:
+	UBountyEffect();
+
+	/// Apply the bounty to the ASC using the class default object.
+	static void ApplyBounty(UAbilitySystemComponent* ASC, const float RewardXP);
+};
@@ -7,6 +7,16 @@
 #include "AbilitySystemComponent.h"
 #include "life_attribute_set.generated.h"
 
+struct FLifePoolValues;
+
+/// One hit this attribute set received during the current frame.
+struct FPendingDamage
+{
+	TWeakObjectPtr<UAbilitySystemComponent> SourceASC;
+	TWeakObjectPtr<AController> SourceController;
+	float Damage = 0.0f;
+};
+
 ///The Getter returns the CurrentValue
 // The Setter sets the BaseValue
 #define ATTRIBUTE_ACCESSORS(ClassName, PropertyName) \
@@ -15,6 +25,53 @@
 	GAMEPLAYATTRIBUTE_VALUE_SETTER(PropertyName) \
 	GAMEPLAYATTRIBUTE_VALUE_INITTER(PropertyName)
 
+/// The health pool attributes quantized into a single struct for replication to simulated proxies.
+/// Values are stored in tenths of a point and only the fields that can't be inferred go on the wire:
+///  - ZeroMask : fields that are 0 are not sent.
+///  - FullMask : Health, Shields and Armor that equal their max are not sent.
+/// Everything else is sent as a packed int.
+USTRUCT()
+struct HERA_API FLifePoolRepData
+{
+	GENERATED_BODY()
+
+	/// Field order for Values and the bits of ZeroMask.
+	enum EField : uint8
+	{
+		MaxHealth,
+		Health,
+		MaxShields,
+		Shields,
+		MaxArmor,
+		Armor,
+		OverHealth,
+		OverArmor,
+		FieldCount
+	};
+
+	/// Quantized values, indexed by EField.
+	uint32 Values[FieldCount] = {};
+
+	float GetValue(EField Field) const;
+
+	/// Returns true if the quantized value changed.
+	bool SetValue(EField Field, float NewValue);
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+	bool operator==(const FLifePoolRepData& Other) const;
+};
+
+template<>
+struct TStructOpsTypeTraits<FLifePoolRepData> : public TStructOpsTypeTraitsBase2<FLifePoolRepData>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithIdenticalViaEquality = true
+	};
+};
+
 /// AttributeSet governing all stats related to having, losing, and gaining health.
 UCLASS()
 class HERA_API ULifeAttributeSet : public UAttributeSet
@@ -29,17 +86,43 @@ class HERA_API ULifeAttributeSet : public UAttributeSet
 	/// Health > Shields > Armor.
 	void HandleHealing(const float HealingReceived);
 
+	/// Snapshot of the life pool attributes for the HeraLifePool kernel.
+	FLifePoolValues GetLifePool() const;
+
+	/// Write back the layers of NewPool that differ from OldPool.
+	void CommitLifePool(const FLifePoolValues& OldPool, const FLifePoolValues& NewPool);
+
 	/// Grant the Source ASC rewards for defeating you.
 	void HandleKillReward(UAbilitySystemComponent* SourceASC);
 
+	/// Add a hit to this frame's pending damage. When coalescing is disabled it's committed right away.
+	void QueueDamage(const float DamageReceived, UAbilitySystemComponent* SourceASC, AController* SourceController);
+
+	/// Commit all pending damage as a single change to the life pool and reward whoever landed the killing blow.
+	void FlushPendingDamage();
+
+	/// Hits received this frame, one entry per hit in the order they arrived.
+	TArray<FPendingDamage> PendingDamage;
+
 public:
 	ULifeAttributeSet();
 
+	/// Server only. Damage that was already mitigated outside of a GameplayEffect, see 
+	/// UAbilitySystemComponentBase::ApplyDirectDamage. Goes through the same HandleDamage and kill reward path as
+	/// the Damage meta attribute.
+	void ReceiveDirectDamage(const float FinalDamage, UAbilitySystemComponent* SourceASC);
+
+	/// Take the Armor and OverArmor that this frame's pending damage will strip off the values a hit is mitigated
+	/// against, so hits later in the frame meet what earlier hits left, the same as without Hera.Damage.Coalesce.
+	void RemovePendingArmor(float& InOutArmor, float& InOutOverArmor) const;
+
 	//------------------------------------------------------------------------------------------------------------------
 	/// MARK: - UAttributeSet overrides
 	//------------------------------------------------------------------------------------------------------------------
 
 	virtual void PreAttributeChange(const FGameplayAttribute& Attribute, float& NewValue) override;
+	virtual void PostAttributeChange(const FGameplayAttribute& Attribute, float OldValue, float NewValue) override;
+	virtual void PostAttributeBaseChange(const FGameplayAttribute& Attribute, float OldValue, float NewValue) const override;
 	virtual void PostGameplayEffectExecute(const FGameplayEffectModCallbackData& Data) override;
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
@@ -179,9 +262,22 @@ public:
 	FGameplayAttributeData RewardXP;
 	ATTRIBUTE_ACCESSORS(ULifeAttributeSet, RewardXP)
 
+	//------------------------------------------------------------------------------------------------------------------
+	/// MARK: - Packed replication
+	//------------------------------------------------------------------------------------------------------------------
+
+	/// Health pool sent to simulated proxies when Hera.Net.PackedLifePool is enabled. The owner keeps receiving the
+	/// individual attributes so prediction still sees the full BaseValue and CurrentValue.
+	UPROPERTY(ReplicatedUsing = OnRep_PackedLifePool)
+	FLifePoolRepData PackedLifePool;
+
 protected:
 	// FGameplayTag HeadShotTag;
 
+	/// Unpacks PackedLifePool and calls the matching OnRep for every attribute that changed.
+	UFUNCTION()
+	virtual void OnRep_PackedLifePool();
+
 	UFUNCTION()
 	virtual void OnRep_MaxHealth(const FGameplayAttributeData& OldMaxHealth);
 
@@ -0,0 +1,92 @@
+// Copyright Final Fall Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/// NOTES:
+// The life pool kernel is the damage/healing cascade of ULifeAttributeSet pulled out into plain C++ so it can
+// run over many pools at once and be benchmarked without an AbilitySystemComponent. It only depends on Core.
+//
+// Damage cascade:  OverArmor > OverHealth > Armor > Shields > Health.
+// Healing cascade: Health > Shields > Armor.
+//
+// Both cascades are greedy fills, so applying d1 then d2 to a pool gives the same result as applying d1 + d2.
+// The batched Resolve functions rely on this to sum a frame's events per pool before walking the cascade once.
+
+/// Values of a single life pool.
+struct HERA_API FLifePoolValues
+{
+	float OverArmor  = 0.0f;
+	float OverHealth = 0.0f;
+	float Armor      = 0.0f;
+	float Shields    = 0.0f;
+	float Health     = 0.0f;
+	float MaxArmor   = 0.0f;
+	float MaxShields = 0.0f;
+	float MaxHealth  = 0.0f;
+};
+
+/// An amount of damage or healing aimed at one pool of an FLifePoolSoA.
+struct HERA_API FLifePoolEvent
+{
+	int32 PoolIndex = INDEX_NONE;
+	float Amount = 0.0f;
+};
+
+/// Many life pools stored as structure-of-arrays so the cascade can walk each layer contiguously.
+struct HERA_API FLifePoolSoA
+{
+	TArray<float> OverArmor;
+	TArray<float> OverHealth;
+	TArray<float> Armor;
+	TArray<float> Shields;
+	TArray<float> Health;
+	TArray<float> MaxArmor;
+	TArray<float> MaxShields;
+	TArray<float> MaxHealth;
+
+	int32 Num() const { return Health.Num(); }
+
+	void Reserve(int32 Count);
+
+	void Reset();
+
+	/// Appends a pool and returns its index.
+	int32 Add(const FLifePoolValues& Pool);
+
+	FLifePoolValues Get(int32 Index) const;
+
+	void Set(int32 Index, const FLifePoolValues& Pool);
+};
+
+namespace HeraLifePool
+{
+	/// Matches ACharacterBase::IsAlive, which checks against the floor because that's what the UI shows.
+	FORCEINLINE bool IsAlive(const FLifePoolValues& Pool)
+	{
+		return FMath::Floor(Pool.Health) > 0;
+	}
+
+	/// Apply damage to a single pool. Returns the damage left over once every layer is empty.
+	HERA_API float ApplyDamage(FLifePoolValues& Pool, float Damage);
+
+	/// Apply healing to a single pool. Returns the healing left over once every healable layer is full.
+	HERA_API float ApplyHealing(FLifePoolValues& Pool, float Healing);
+
+	/// Apply one damage amount per pool. DamagePerPool must have Pools.Num() entries.
+	/// Runs four pools at a time on the vector unit with a scalar tail.
+	HERA_API void ApplyDamage(FLifePoolSoA& Pools, TArrayView<const float> DamagePerPool);
+
+	/// Apply one healing amount per pool. HealingPerPool must have Pools.Num() entries.
+	/// Runs four pools at a time on the vector unit with a scalar tail.
+	HERA_API void ApplyHealing(FLifePoolSoA& Pools, TArrayView<const float> HealingPerPool);
+
+	/// Sum a frame's damage events per pool into Scratch and resolve them in one pass.
+	/// Events with an invalid PoolIndex or a non-positive Amount are ignored.
+	HERA_API void ResolveDamage(FLifePoolSoA& Pools, TArrayView<const FLifePoolEvent> Events, TArray<float>& Scratch);
+
+	/// Sum a frame's healing events per pool into Scratch and resolve them in one pass.
+	/// Events with an invalid PoolIndex or a non-positive Amount are ignored.
+	HERA_API void ResolveHealing(FLifePoolSoA& Pools, TArrayView<const FLifePoolEvent> Events, TArray<float>& Scratch);
+}
@@ -11,6 +11,8 @@ namespace HeraTags
    const FGameplayTag Tag_Healing = FGameplayTag::RequestGameplayTag(FName("Effect.Healing"));
    const FGameplayTag Tag_Buff = FGameplayTag::RequestGameplayTag(FName("Effect.Buff"));
    const FGameplayTag Tag_Debuff = FGameplayTag::RequestGameplayTag(FName("Effect.Debuff"));
+   const FGameplayTag Tag_BountyXP = FGameplayTag::RequestGameplayTag(FName("Effect.Bounty.XP"));
+   const FGameplayTag Tag_BountyGold = FGameplayTag::RequestGameplayTag(FName("Effect.Bounty.Gold"));
 
    const FGameplayTag Tag_MeleeAttack = FGameplayTag::RequestGameplayTag(FName("Attack.Melee"));
    const FGameplayTag Tag_BalisticAttack = FGameplayTag::RequestGameplayTag(FName("Attack.Balistic"));
@@ -20,4 +22,7 @@ namespace HeraTags
 
    /// CHARACTER:
    const FGameplayTag Tag_Landed = FGameplayTag::RequestGameplayTag(FName("Character.State.Landed"));
+
+   /// GAMEPLAY CUES:
+   const FGameplayTag Tag_CueWeaponFire = FGameplayTag::RequestGameplayTag(FName("GameplayCue.Weapon.Fire"));
 }
\ No newline at end of file
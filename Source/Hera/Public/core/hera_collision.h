@@ -0,0 +1,19 @@
+// Copyright Final Fall Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+
+/// NOTES:
+// - Collision profiles and channels are set up in Config/DefaultEngine.ini. Code refers to them through here
+//   so a rename only has to happen in one place.
+
+namespace HeraCollision
+{
+	/// The collision profile of projectiles. Hitscan traces use it too so both hit the same things.
+	extern HERA_API const FName kProjectileProfile;
+
+	/// The object channel of kProjectileProfile, for traces that need to override its responses.
+	HERA_API ECollisionChannel GetProjectileChannel();
+}
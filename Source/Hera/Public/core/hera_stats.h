@@ -0,0 +1,30 @@
+// Copyright Final Fall Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+/// NOTES:
+// - `stat Hera` shows the cycle counters and counters below in game.
+// - Unreal Insights shows the same scopes on the CPU track when tracing with -trace=cpu.
+// - `csvprofile start`/`csvprofile stop` records the timings and counters under the Hera category.
+
+DECLARE_STATS_GROUP(TEXT("Hera"), STATGROUP_Hera, STATCAT_Advanced);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Hits/frame"), STAT_Hera_HitsPerFrame, STATGROUP_Hera, HERA_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Kills/frame"), STAT_Hera_KillsPerFrame, STATGROUP_Hera, HERA_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Projectiles alive"), STAT_Hera_ProjectilesAlive, STATGROUP_Hera, HERA_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Projectiles simulated"), STAT_Hera_ProjectilesSimulated, STATGROUP_Hera, HERA_API);
+
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(HERA_API, Hera);
+
+/// Time the enclosing scope as a stat cycle counter, an Insights CPU event and a CSV timing.
+/// The cycle stat has to be declared in the .cpp with
+///   DECLARE_CYCLE_STAT(TEXT("Name"), STAT_Hera_Name, STATGROUP_Hera);
+#define HERA_SCOPE_CYCLE_COUNTER(Name) \
+	SCOPE_CYCLE_COUNTER(STAT_Hera_##Name); \
+	TRACE_CPUPROFILER_EVENT_SCOPE(Hera_##Name); \
+	CSV_SCOPED_TIMING_STAT(Hera, Name)
@@ -0,0 +1,173 @@
+// Copyright Final Fall Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "Containers/Queue.h"
+#include <atomic>
+
+/// NOTES:
+// The combat log records every damage, healing and kill event of a match for offline balance work.
+// - The game thread pushes fixed size FCombatLogEvents into a single-producer/single-consumer ring buffer.
+// - FCombatLogWriter owns a background thread that drains the ring and appends the events to a binary file,
+//   so the game thread never touches the disk.
+// - FCombatLogReader loads a file back for analysis. See the Hera.CombatLog.Summarize console command.
+//
+// File layout, little endian:
+//   FCombatLogHeader
+//   Blocks, each starting with an ECombatLogBlock byte and a uint32 count:
+//     Events : count * FCombatLogEvent, written as raw bytes
+//     Names  : count * (uint32 ActorId, FString Name)
+//     End    : count is 0, nothing follows
+
+enum class ECombatLogEventType : uint8
+{
+	Damage,
+	Healing,
+	Kill,
+};
+
+/// One combat event. Plain data so the ring buffer and the file can copy it around as bytes.
+struct FCombatLogEvent
+{
+	ECombatLogEventType Type = ECombatLogEventType::Damage;
+	uint8 Padding[3] = { 0, 0, 0 };
+
+	/// GFrameCounter when the event happened, truncated.
+	uint32 Frame = 0;
+
+	/// World time in seconds.
+	float Time = 0.0f;
+
+	/// Ids of the source and target avatars. The Names block maps them back to actor names. 0 means unknown.
+	uint32 SourceId = 0;
+	uint32 TargetId = 0;
+
+	/// Damage or healing before and after mitigation. Zero for kills.
+	float UnmitigatedAmount = 0.0f;
+	float FinalAmount = 0.0f;
+};
+
+static_assert(sizeof(FCombatLogEvent) == 28, "FCombatLogEvent is written as raw bytes. Bump kCombatLogVersion when its layout changes.");
+static_assert(TIsTriviallyDestructible<FCombatLogEvent>::Value, "FCombatLogEvent must stay plain data.");
+
+enum class ECombatLogBlock : uint8
+{
+	End,
+	Events,
+	Names,
+};
+
+/// "HCLG"
+static constexpr uint32 kCombatLogMagic = 0x474C4348;
+static constexpr uint32 kCombatLogVersion = 1;
+
+struct FCombatLogHeader
+{
+	uint32 Magic = kCombatLogMagic;
+	uint32 Version = kCombatLogVersion;
+	uint32 EventSize = sizeof(FCombatLogEvent);
+
+	/// UTC ticks of when the log was opened.
+	int64 StartTicks = 0;
+
+	friend FArchive& operator<<(FArchive& Ar, FCombatLogHeader& Header);
+};
+
+/// Bounded lock-free ring of combat events for exactly one producer thread and one consumer thread.
+/// Pushing into a full ring drops the event instead of blocking the game thread.
+class HERA_API FCombatLogRing
+{
+public:
+	/// Capacity is rounded up to a power of two.
+	explicit FCombatLogRing(uint32 Capacity);
+
+	/// Producer only. Returns false and counts the event as dropped when the ring is full.
+	bool Push(const FCombatLogEvent& Event);
+
+	/// Consumer only. Appends up to MaxCount events to OutEvents and returns how many were taken.
+	int32 Pop(TArray<FCombatLogEvent>& OutEvents, int32 MaxCount);
+
+	bool IsEmpty() const;
+
+	uint32 GetDroppedCount() const { return DroppedCount.load(std::memory_order_relaxed); }
+
+private:
+	TArray<FCombatLogEvent> Events;
+	uint32 Mask = 0;
+
+	/// Written by the producer. Kept on their own cache lines so the two threads don't fight over them.
+	alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint32> Head { 0 };
+
+	/// Written by the consumer.
+	alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint32> Tail { 0 };
+
+	std::atomic<uint32> DroppedCount { 0 };
+};
+
+/// Owns the ring buffer and the background thread that writes it to disk.
+/// Log and AddName must be called from a single thread, normally the game thread.
+class HERA_API FCombatLogWriter : public FRunnable
+{
+public:
+	FCombatLogWriter(const FString& InFilename, uint32 Capacity);
+
+	/// Stops the thread after writing everything still in the ring.
+	virtual ~FCombatLogWriter();
+
+	void Log(const FCombatLogEvent& Event);
+
+	/// Record the name of an actor id. Call once per id.
+	void AddName(uint32 ActorId, const FString& Name);
+
+	const FString& GetFilename() const { return Filename; }
+
+	uint32 GetDroppedCount() const { return Ring.GetDroppedCount(); }
+
+	//~ FRunnable
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+	/// Writer thread only. Moves whatever is queued to the file.
+	void Drain(FArchive& Ar);
+
+	struct FPendingName
+	{
+		uint32 ActorId = 0;
+		FString Name;
+	};
+
+	FString Filename;
+	FCombatLogRing Ring;
+
+	/// Names are rare, so they go through a node based queue instead of the ring.
+	TQueue<FPendingName, EQueueMode::Spsc> PendingNames;
+
+	/// Writer thread scratch space.
+	TArray<FCombatLogEvent> DrainBuffer;
+
+	std::atomic<bool> IsStopping { false };
+	FEvent* WakeEvent = nullptr;
+	FRunnableThread* Thread = nullptr;
+};
+
+/// The contents of a combat log file.
+struct HERA_API FCombatLogFile
+{
+	FCombatLogHeader Header;
+	TArray<FCombatLogEvent> Events;
+	TMap<uint32, FString> Names;
+
+	/// Name of an actor id, or the id itself when the log doesn't have it.
+	FString GetName(uint32 ActorId) const;
+};
+
+class HERA_API FCombatLogReader
+{
+public:
+	/// Load a whole combat log. Returns false if the file is missing, from another version or truncated
+	/// before its first block. A log cut short by a crash loads up to the last complete block.
+	static bool ReadFile(const FString& Filename, FCombatLogFile& OutFile);
+};
@@ -0,0 +1,51 @@
+// Copyright Final Fall Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "core/logging/combat_log.h"
+#include "UObject/ObjectKey.h"
+#include "combat_log_subsystem.generated.h"
+
+class UAbilitySystemComponent;
+
+/// Records the combat of a match to Saved/CombatLogs when Hera.CombatLog is on. Only runs where damage is
+/// resolved, so on the server or in standalone games.
+UCLASS()
+class HERA_API UCombatLogSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/// The combat log of the world, or null when the world isn't recording.
+	static UCombatLogSubsystem* Get(const UObject* WorldContextObject);
+
+	void LogDamage(const UAbilitySystemComponent* SourceASC, const UAbilitySystemComponent* TargetASC, float UnmitigatedDamage, float FinalDamage);
+
+	void LogHealing(const UAbilitySystemComponent* SourceASC, const UAbilitySystemComponent* TargetASC, float UnmitigatedHealing, float FinalHealing);
+
+	void LogKill(const UAbilitySystemComponent* SourceASC, const UAbilitySystemComponent* TargetASC);
+
+	bool IsRecording() const { return Writer.IsValid(); }
+
+	//~ UWorldSubsystem
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	void Log(ECombatLogEventType Type, const UAbilitySystemComponent* SourceASC, const UAbilitySystemComponent* TargetASC, float UnmitigatedAmount, float FinalAmount);
+
+	/// Log id of the ASC's avatar. Assigns one and sends the actor's name to the log the first time it's seen.
+	uint32 GetActorId(const UAbilitySystemComponent* ASC);
+
+	TUniquePtr<FCombatLogWriter> Writer;
+
+	/// Ids handed out to actors so far. Ids count up from 1 and are never reused within a log, unlike
+	/// UObject unique ids which are recycled after garbage collection.
+	TMap<TObjectKey<AActor>, uint32> ActorIds;
+	uint32 NextActorId = 1;
+};
@@ -0,0 +1,66 @@
+// Copyright Final Fall Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "cosmetic_feedback_subsystem.generated.h"
+
+class UAnimMontage;
+class UAudioComponent;
+class USkeletalMeshComponent;
+class USoundBase;
+
+/// Sound and animation of one weapon firing, waiting for the end of the frame.
+struct FFireFeedback
+{
+	TWeakObjectPtr<USoundBase> Sound;
+	TWeakObjectPtr<UAnimMontage> Montage;
+	TWeakObjectPtr<USkeletalMeshComponent> Mesh;
+	FVector Location = FVector::ZeroVector;
+};
+
+/// Plays weapon fire feedback queued through the GameplayCue.Weapon.Fire cue, once per frame.
+///
+/// NOTES:
+// - Identical feedback queued in the same frame plays once: the same sound close to where it already plays, and
+//   the same montage on the same mesh.
+// - Sounds play on a pool of at most Hera.Cosmetics.MaxAudioComponents audio components. When they're all busy
+//   the one started longest ago is cut off, so heavy gunfire never creates more.
+// - Never created on a dedicated server.
+UCLASS()
+class HERA_API UCosmeticFeedbackSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void QueueFireFeedback(USoundBase* Sound, UAnimMontage* Montage, USkeletalMeshComponent* Mesh, const FVector& Location);
+
+	int32 GetNumAudioComponents() const { return AudioComponents.Num(); }
+
+	//~ UTickableWorldSubsystem
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual void Deinitialize() override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/// Play everything queued this frame.
+	void Flush();
+
+	void PlaySound(USoundBase* Sound, const FVector& Location);
+
+	/// An idle audio component from the pool, a new one while the pool has room, or the oldest playing one.
+	UAudioComponent* AcquireAudioComponent(USoundBase* Sound, const FVector& Location);
+
+	/// Feedback queued this frame, already coalesced.
+	TArray<FFireFeedback> Pending;
+
+	UPROPERTY()
+	TArray<TObjectPtr<UAudioComponent>> AudioComponents;
+
+	/// The pooled component cut off next when they're all busy. Components are started in this order too.
+	int32 NextToSteal = 0;
+};
@@ -0,0 +1,137 @@
+// Copyright Final Fall Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "core/ui/healthbar_overlay.h"
+#include "healthbar_subsystem.generated.h"
+
+class ACharacterBase;
+class UHealthbarWidget;
+struct FStreamableHandle;
+
+/// How floating healthbars are drawn. Hera.UI.HealthbarMode.
+enum class EHealthbarMode : uint8
+{
+	/// A UHealthbarWidget in a screen space UWidgetComponent on every character.
+	PerActor = 0,
+
+	/// Every bar drawn by one SHealthbarOverlay.
+	Batched = 1,
+
+	/// A fixed pool of UHealthbarWidgets bound to the most relevant characters.
+	Pooled = 2,
+};
+
+/// A registered character whose healthbar is on screen this frame.
+struct FVisibleHealthbar
+{
+	ACharacterBase* Character = nullptr;
+
+	/// Viewport pixels.
+	FVector2D ScreenPosition = FVector2D::ZeroVector;
+
+	float Scale = 1.0f;
+
+	/// From the view, cm.
+	float Distance = 0.0f;
+};
+
+/// Keeps every floating healthbar up to date. In Batched mode it draws them all in one SHealthbarOverlay over the
+/// game viewport, in Pooled mode it shows them with a fixed pool of widgets.
+///
+/// NOTES:
+// - Characters mark their life pool dirty whenever a life attribute changes. Dirty characters are flushed at most
+//   Hera.UI.HealthbarFlushRate times a second, every frame at 0: one FHealthbarSnapshot is read and handed to the
+//   character's widget in a single call. Characters off screen stay dirty until they're back.
+// - Characters register in ACharacterBase::InitializeFloatingHealthbar unless Hera.UI.HealthbarMode is PerActor and
+//   leave in EndPlay. Switching to or from PerActor only applies to characters that set up their healthbar after.
+// - Every frame the registered characters that were rendered lately and aren't culled by significance are projected
+//   into the viewport and their life pool is packed into one FHealthbarDrawData each.
+// - In Pooled mode the Hera.UI.HealthbarPoolSize most significant, then closest, visible characters get a widget
+//   instead. A character keeps its widget while it stays among them, so widgets are only rebound as characters
+//   come and go. The pool never grows past its size, whatever the number of characters.
+// - Starts loading ACharacterBase's default healthbar widget class when the world starts, unless the mode doesn't
+//   use widgets. Being client only, that keeps the class off dedicated servers.
+// - Never created on a dedicated server.
+UCLASS()
+class HERA_API UHealthbarSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void Register(ACharacterBase* Character);
+
+	void Unregister(ACharacterBase* Character);
+
+	int32 GetNumRegistered() const { return Characters.Num(); }
+
+	/// A life attribute of Character changed. Its healthbar is updated at the next flush it's on screen for.
+	void MarkDirty(ACharacterBase* Character);
+
+	int32 GetNumDirty() const { return DirtyCharacters.Num(); }
+
+	static EHealthbarMode GetMode();
+
+	//~ UTickableWorldSubsystem
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual void Deinitialize() override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/// Add the overlay to the game viewport if it isn't yet. False without a viewport.
+	bool AddOverlay();
+
+	void RemoveOverlay();
+
+	/// Project every registered character whose bar is on screen this frame.
+	void GatherVisibleHealthbars(TArray<FVisibleHealthbar>& OutHealthbars) const;
+
+	/// Bind the pooled widgets to the most relevant of Visible and move them over their characters. Reorders Visible.
+	void UpdatePool(TArrayView<FVisibleHealthbar> Visible);
+
+	/// A pooled widget bound to nothing, created if the pool isn't full yet. INDEX_NONE when it's full.
+	int32 AcquirePooledWidget(int32 PoolSize);
+
+	/// Load the pool's widget class if it isn't yet. False until it's loaded.
+	bool ResolvePooledWidgetClass();
+
+	/// Hand a fresh snapshot to every dirty character on screen.
+	void FlushDirty();
+
+	TArray<TWeakObjectPtr<ACharacterBase>> Characters;
+
+	TArray<TWeakObjectPtr<ACharacterBase>> DirtyCharacters;
+
+	/// Seconds since the last FlushDirty.
+	float TimeSinceFlush = 0.0f;
+
+	TSharedPtr<SHealthbarOverlay> Overlay;
+
+	/// Scratch for Tick, kept to avoid reallocating.
+	TArray<FVisibleHealthbar> VisibleHealthbars;
+
+	/// Preloads the default healthbar widget class, so characters rarely wait for it.
+	TSharedPtr<FStreamableHandle> WidgetClassHandle;
+
+	/// Widget class of the pool, from the first character registered. Characters registered in another mode don't
+	/// load it, so it's resolved when the pool first needs a widget.
+	TSoftClassPtr<UHealthbarWidget> PooledWidgetSoftClass;
+
+	/// Keeps PooledWidgetSoftClass loaded once the pool needed it.
+	TSharedPtr<FStreamableHandle> PooledWidgetClassHandle;
+
+	UPROPERTY()
+	TSubclassOf<UHealthbarWidget> PooledWidgetClass;
+
+	UPROPERTY()
+	TArray<TObjectPtr<UHealthbarWidget>> PooledWidgets;
+
+	/// The character each pooled widget shows, null when it's free.
+	TArray<TWeakObjectPtr<ACharacterBase>> PooledCharacters;
+};
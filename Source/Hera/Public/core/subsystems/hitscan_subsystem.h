@@ -0,0 +1,103 @@
+// Copyright Final Fall Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GameplayEffect.h"
+#include "WorldCollision.h"
+#include "hitscan_subsystem.generated.h"
+
+/// One trigger pull of a hitscan weapon. Every pellet is traced separately.
+struct HERA_API FHitscanShot
+{
+	FVector Origin = FVector::ZeroVector;
+	FVector Direction = FVector::ForwardVector;
+
+	/// Length of each trace in cm.
+	float Range = 10000.0f;
+
+	int32 PelletCount = 1;
+
+	/// Half angle of the cone the pellets are spread over, in degrees. 0 sends every pellet straight ahead.
+	float SpreadDegrees = 0.0f;
+
+	/// Seeds the pellet pattern, so the same shot always spreads the same way.
+	int32 Seed = 0;
+
+	/// Ignored by the traces and credited with the damage.
+	TWeakObjectPtr<AActor> Instigator;
+
+	/// Applied once per pellet that hits something with an AbilitySystemComponent.
+	FGameplayEffectSpecHandle EffectSpecHandle;
+
+	/// Damage per pellet through UAbilitySystemComponentBase::ApplyDirectDamage when there's no EffectSpecHandle.
+	float DirectDamage = 0.0f;
+
+	/// Impulse per pellet on physics objects, scaled by their mass.
+	float ImpulseStrength = 500.0f;
+
+	/// Server time the shooter saw when they fired. Characters are hit where they were then, through
+	/// ULagCompensationSubsystem. Negative for shots fired on the server, which aren't rewound.
+	float ShooterTime = -1.0f;
+};
+
+/// One traced pellet and what it carries.
+struct FHitscanPellet
+{
+	FVector Start = FVector::ZeroVector;
+	FVector End = FVector::ZeroVector;
+
+	/// Index of the shot in the frame it was queued, which is the order its hits are resolved in.
+	int32 ShotIndex = 0;
+
+	FTraceHandle Handle;
+};
+
+/// Traces every hitscan shot of a frame as one batch of async line traces.
+///
+/// NOTES:
+// - Weapons queue shots during the frame. At the end of the frame the subsystem expands them into pellets and
+//   issues one async trace per pellet with the "Projectile" collision profile.
+// - The next tick collects the results and applies them in the order the shots were queued: physics impulse,
+//   then damage on the authority. A trace that isn't back yet runs synchronously so no shot is dropped.
+// - On the authority, a shot with a ShooterTime hits characters where they were at that time. The world trace
+//   only decides where the pellet stops.
+UCLASS()
+class HERA_API UHitscanSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/// Queue a shot for this frame's batch.
+	void QueueShot(const FHitscanShot& Shot);
+
+	int32 GetNumQueuedShots() const { return QueuedShots.Num(); }
+
+	//~ UTickableWorldSubsystem
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual void Deinitialize() override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/// Resolve the pellets traced last frame.
+	void ResolvePellets();
+
+	/// Expand the queued shots into pellets and start their traces.
+	void IssuePellets();
+
+	/// Replace the character hit of a pellet with the one it hits at the shot's ShooterTime. Returns whether the
+	/// pellet hits anything.
+	bool RewindPellet(const FHitscanShot& Shot, const FHitscanPellet& Pellet, FHitResult& InOutHit, bool DidHit) const;
+
+	/// Shots queued this frame.
+	TArray<FHitscanShot> QueuedShots;
+
+	/// Shots whose pellets are being traced, in the order they were queued.
+	TArray<FHitscanShot> TracedShots;
+
+	/// Pellets of TracedShots, grouped by shot.
+	TArray<FHitscanPellet> Pellets;
+};
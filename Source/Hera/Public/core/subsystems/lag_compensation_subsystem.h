@@ -0,0 +1,144 @@
+// Copyright Final Fall Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "lag_compensation_subsystem.generated.h"
+
+class ACharacterBase;
+
+/// Frames of history kept per character. About a second at 60 Hz, two at 30 Hz.
+constexpr int32 kLagCompensationFrames = 64;
+
+/// Most hit zones recorded per character.
+constexpr int32 kLagCompensationMaxHitZones = 4;
+
+/// Sphere around a bone that is hit separately from the body, e.g. the head.
+USTRUCT(BlueprintType)
+struct HERA_API FLagCompensationHitZone
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Hera|Lag Compensation")
+	FName Bone;
+
+	/// cm
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Hera|Lag Compensation")
+	float Radius = 15.0f;
+};
+
+/// A character found by a rewind query, where it was at the queried time.
+struct HERA_API FLagCompensationHit
+{
+	ACharacterBase* Character = nullptr;
+
+	/// Closest point of the trace to the rewound character.
+	FVector Location = FVector::ZeroVector;
+
+	/// Distance from the start of the trace to Location.
+	float Distance = 0.0f;
+
+	/// Index into the character's HitZones, or INDEX_NONE for the body.
+	int32 HitZone = INDEX_NONE;
+};
+
+/// Recorded poses, one slot per character. All the frames of a slot are contiguous, so rewinding a character reads
+/// two neighbouring records. Positions are FVector3f to keep a record small.
+struct HERA_API FLagCompensationHistory
+{
+	/// Server time of each frame. A ring shared by every slot.
+	TArray<float> FrameTimes;
+	int32 NewestFrame = INDEX_NONE;
+	int32 NumFrames = 0;
+
+	/// Per slot.
+	TArray<TWeakObjectPtr<ACharacterBase>> Characters;
+	TArray<float> Radii;
+	TArray<uint8> NumHitZones;
+
+	/// Per slot and hit zone, at Slot * kLagCompensationMaxHitZones + Zone.
+	TArray<float> HitZoneRadii;
+
+	/// Per slot and frame, at Slot * kLagCompensationFrames + Frame.
+	TArray<FVector3f> Locations;
+	TArray<float> HalfHeights;
+
+	/// Per slot, frame and hit zone, at (Slot * kLagCompensationFrames + Frame) * kLagCompensationMaxHitZones + Zone.
+	TArray<FVector3f> HitZoneCenters;
+
+	int32 NumSlots() const { return Characters.Num(); }
+
+	/// Grow every per slot array by one slot. Returns its index.
+	int32 AddSlot();
+
+	void Reset();
+};
+
+/// Remembers where every ACharacterBase was over the last kLagCompensationFrames server ticks, so hits can be
+/// checked against where targets were when the shooter fired instead of where they are now.
+///
+/// NOTES:
+// - Characters register themselves on the server in BeginPlay and leave in EndPlay. Each slot is a fixed
+//   kLagCompensationFrames records: the capsule and the hit zones of ACharacterBase::HitZones.
+// - Poses are recorded once per tick, after the actors have moved.
+// - The shooter's time is the server time they saw when firing, e.g. AGameStateBase::GetServerWorldTimeSeconds on
+//   their client. Rewinds are clamped to Hera.LagCompensation.MaxRewindMs so a client can't claim an old shot.
+// - Only runs where hits are decided, never on clients.
+UCLASS()
+class HERA_API ULagCompensationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void Register(ACharacterBase* Character);
+
+	void Unregister(ACharacterBase* Character);
+
+	bool IsRecorded(const AActor* Actor) const;
+
+	int32 GetNumRecorded() const { return SlotsByCharacter.Num(); }
+
+	/// Snapshot every registered character as the newest frame.
+	void Record(float ServerTime);
+
+	/// The closest character a sphere of Radius swept from Start to End touches, with every character where it was
+	/// at ServerTime. Radius 0 is a line trace.
+	bool RewindTrace(
+		float ServerTime,
+		const FVector& Start,
+		const FVector& End,
+		float Radius,
+		const AActor* IgnoreActor,
+		FLagCompensationHit& OutHit
+	) const;
+
+	/// Where Character's capsule was at ServerTime.
+	bool GetRewoundLocation(const ACharacterBase* Character, float ServerTime, FVector& OutLocation) const;
+
+	/// Whether rewinding is on.
+	static bool IsEnabled();
+
+	//~ UTickableWorldSubsystem
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual void Deinitialize() override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/// The recorded frames either side of ServerTime, after clamping it to the rewind limit, and how far between
+	/// them it is. False when nothing was recorded yet.
+	bool FindFrames(float ServerTime, int32& OutOlder, int32& OutNewer, float& OutAlpha) const;
+
+	/// Write Character's current pose into one frame of its slot.
+	void WritePose(int32 Slot, int32 Frame, const ACharacterBase* Character);
+
+	FLagCompensationHistory History;
+
+	TMap<TObjectKey<ACharacterBase>, int32> SlotsByCharacter;
+
+	/// Slots of characters that left, reused before the history grows.
+	TArray<int32> FreeSlots;
+};
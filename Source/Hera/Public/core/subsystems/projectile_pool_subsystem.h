@@ -0,0 +1,70 @@
+// Copyright Final Fall Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GameplayEffect.h"
+#include "projectile_pool_subsystem.generated.h"
+
+class AProjectileBase;
+
+/// Free projectiles of one class.
+USTRUCT()
+struct FProjectilePool
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<TObjectPtr<AProjectileBase>> Free;
+};
+
+/// Recycles projectiles instead of spawning one per shot and destroying it on hit or expiry.
+///
+/// NOTES:
+// - Projectiles are reused where they were spawned. On the server, clients see a reused projectile through
+//   AProjectileBase::PoolState and the actor goes dormant while it sits in the pool.
+// - Hera.Projectile.Pool 0 turns pooling off, Acquire then spawns and projectiles destroy themselves like before.
+UCLASS()
+class HERA_API UProjectilePoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/// Take a projectile from the pool, or spawn one if it's empty, and launch it from SpawnTransform.
+	/// DirectDamage is the damage of its hit without an effect spec. Negative keeps the class's own Damage.
+	AProjectileBase* Acquire(
+		TSubclassOf<AProjectileBase> ProjectileClass,
+		const FTransform& SpawnTransform,
+		AActor* Owner = nullptr,
+		APawn* Instigator = nullptr,
+		const FGameplayEffectSpecHandle& EffectSpecHandle = FGameplayEffectSpecHandle(),
+		float DirectDamage = -1.0f
+	);
+
+	/// Put a projectile back in its pool. Projectiles past the pool's size limit are destroyed.
+	void Release(AProjectileBase* Projectile);
+
+	/// Spawn projectiles ahead of time so the first shots don't pay for spawning.
+	void Prewarm(TSubclassOf<AProjectileBase> ProjectileClass, int32 Count);
+
+	/// Prewarm with the Hera.Projectile.PoolPrewarm count.
+	void Prewarm(TSubclassOf<AProjectileBase> ProjectileClass);
+
+	int32 GetNumFree(TSubclassOf<AProjectileBase> ProjectileClass) const;
+
+	static bool IsPoolingEnabled();
+
+	//~ UWorldSubsystem
+	virtual void Deinitialize() override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/// Spawn a projectile that belongs to this pool. It starts out of play.
+	AProjectileBase* SpawnPooled(UClass* ProjectileClass, const FTransform& SpawnTransform);
+
+	UPROPERTY()
+	TMap<TObjectPtr<UClass>, FProjectilePool> Pools;
+};
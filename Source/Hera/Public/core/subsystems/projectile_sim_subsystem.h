@@ -0,0 +1,249 @@
+// Copyright Final Fall Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GameplayEffect.h"
+#include "WorldCollision.h"
+#include "Engine/NetSerialization.h"
+#include "projectile_sim_subsystem.generated.h"
+
+class AProjectileBase;
+class UAbilitySystemComponent;
+
+/// Everything needed to launch a projectile into UProjectileSimSubsystem.
+struct HERA_API FProjectileLaunchParams
+{
+	FVector Origin = FVector::ZeroVector;
+	FVector Velocity = FVector::ZeroVector;
+
+	/// Radius of the swept sphere in cm.
+	float Radius = 5.0f;
+
+	/// Multiplier on the world gravity. 0 flies straight.
+	float GravityScale = 0.0f;
+
+	/// Seconds before the projectile expires without hitting anything.
+	float LifeSpan = 3.0f;
+
+	/// Ignored by the sweeps and credited with the damage.
+	TWeakObjectPtr<AActor> Instigator;
+
+	/// Applied to whatever the projectile hits when it has an AbilitySystemComponent.
+	FGameplayEffectSpecHandle EffectSpecHandle;
+
+	/// Damage applied through UAbilitySystemComponentBase::ApplyDirectDamage when there's no EffectSpecHandle.
+	float DirectDamage = 0.0f;
+
+	/// Actor shown along the path. Only spawned where something renders, never on a dedicated server.
+	TSubclassOf<AProjectileBase> VisualClass;
+
+	/// Launch params matching how ProjectileClass flies as an actor: speed, gravity and lifespan from its
+	/// ProjectileMovement and radius from its root sphere.
+	static FProjectileLaunchParams FromClass(TSubclassOf<AProjectileBase> ProjectileClass, const FVector& Origin, const FRotator& Direction);
+};
+
+/// Everything a client needs to fly a projectile the server launched, sent instead of a replicated actor.
+///
+/// NOTES:
+// - Origin is quantized to 0.1 cm, direction to a 16 bit yaw and pitch and speed to whole cm/s. Together with
+//   the class, which is a NetGUID after its first send, an event is a few dozen bytes and opens no actor channel.
+// - ServerTime is when the server launched it. Clients fast forward by how long the event took to arrive.
+// - Seed is the shooter's shot count, for anything about the shot that's random, so every machine rolls the same.
+USTRUCT()
+struct HERA_API FProjectileSpawnEvent
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TSubclassOf<AProjectileBase> ProjectileClass;
+
+	FVector Origin = FVector::ZeroVector;
+	uint16 Yaw = 0;
+	uint16 Pitch = 0;
+
+	/// cm/s
+	uint32 Speed = 0;
+
+	/// AGameStateBase::GetServerWorldTimeSeconds when the projectile was launched.
+	float ServerTime = 0.0f;
+
+	uint16 Seed = 0;
+
+	FVector GetVelocity() const;
+
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FProjectileSpawnEvent> : public TStructOpsTypeTraitsBase2<FProjectileSpawnEvent>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+/// Data of a projectile that isn't touched by the integration or the sweeps.
+struct FProjectileSimPayload
+{
+	TWeakObjectPtr<AActor> Instigator;
+	FGameplayEffectSpecHandle EffectSpecHandle;
+	float DirectDamage = 0.0f;
+	TWeakObjectPtr<AProjectileBase> Visual;
+};
+
+/// Ballistic projectiles as structure-of-arrays so the integration walks contiguous memory.
+struct HERA_API FProjectileSimState
+{
+	/// Launch order, used to resolve a frame's hits in the order the projectiles were fired.
+	TArray<uint32> Ids;
+	TArray<FVector> Positions;
+	TArray<FVector> Velocities;
+	TArray<float> Radii;
+	TArray<float> GravityScales;
+	TArray<float> TimesLeft;
+	TArray<FProjectileSimPayload> Payloads;
+
+	int32 Num() const { return Ids.Num(); }
+
+	int32 Add(uint32 Id, const FProjectileLaunchParams& Params);
+
+	/// Swaps the last projectile into Index.
+	void RemoveAtSwap(int32 Index);
+
+	void Reset();
+};
+
+/// A projectile that hit something this frame.
+struct FProjectileImpact
+{
+	uint32 Id = 0;
+	FHitResult Hit;
+	FVector Velocity = FVector::ZeroVector;
+	FProjectileSimPayload Payload;
+};
+
+/// Simulates ballistic projectiles without an actor or components each.
+///
+/// NOTES:
+// - Every frame integrates all projectiles in one pass, sweeps them against the world with the "Projectile"
+//   collision profile, then resolves the hits in launch order: physics impulse, then damage on the authority.
+// - Hera.Projectile.SweepMode picks how the sweeps run: one after the other on the game thread, spread over
+//   worker threads with ParallelFor, or as async scene queries that are resolved at the start of the next tick.
+//   Whatever the mode, hits are only ever applied in Resolve, on the game thread, in launch order.
+// - Projectile classes opt in with AProjectileBase::UseBatchedSimulation. The actor class is then only a visual
+//   that follows the simulated position. Projectiles that need their own behaviour keep flying as actors.
+// - Hera.Projectile.Batched 0 makes everything fly as actors again.
+// - On a networked server, Hera.Projectile.SpawnEvents 1 sends each launch to clients as an FProjectileSpawnEvent
+//   and they simulate their own copy here. Only the server's copy applies damage. With 0, batched classes fly as
+//   replicated actors on a networked server so clients still see them.
+UCLASS()
+class HERA_API UProjectileSimSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/// Start simulating a projectile. Returns its id.
+	/// FastForwardSeconds starts it that far along its path. Returns 0 when it would already have hit something or
+	/// expired by then, in which case nothing is launched. With authority, a hit on the way is applied right away.
+	uint32 Launch(const FProjectileLaunchParams& Params, float FastForwardSeconds = 0.0f);
+
+	/// Launch a client copy of a projectile the server sent. Instigator is the character that fired it.
+	uint32 LaunchFromSpawnEvent(const FProjectileSpawnEvent& Event, AActor* Instigator);
+
+	/// Describe a projectile launched here so clients can launch their own copy. Age is how long ago it left
+	/// Params.Origin, for projectiles launched fast forwarded.
+	FProjectileSpawnEvent MakeSpawnEvent(
+		TSubclassOf<AProjectileBase> ProjectileClass, 
+		const FProjectileLaunchParams& Params, 
+		uint16 Seed, 
+		float Age = 0.0f
+	) const;
+
+	int32 GetNumProjectiles() const { return State.Num(); }
+
+	/// Async sweeps that weren't back by the next tick and ran on the game thread instead, since the world started.
+	/// The "Projectile sweeps late" stat shows the same per frame.
+	uint32 GetNumSweepsLate() const { return NumSweepsLate; }
+
+	/// Whether ProjectileClass should be launched here instead of spawned as an actor.
+	static bool ShouldSimulate(TSubclassOf<AProjectileBase> ProjectileClass, const UWorld* World);
+
+	/// Whether launches in World should be sent to clients as spawn events.
+	static bool ShouldSendSpawnEvents(const UWorld* World);
+
+	//~ UTickableWorldSubsystem
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual void Deinitialize() override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/// Synchronized time, the same on the server and its clients.
+	float GetServerTime() const;
+
+	/// Advance Params along its path by Seconds. Returns false when it hits something or expires on the way.
+	/// OutHit is the blocking hit, if any, and Params are left where and how fast the projectile hit it.
+	bool FastForward(FProjectileLaunchParams& Params, float Seconds, FHitResult& OutHit) const;
+
+	/// Move every projectile and count down its lifespan.
+	void Integrate(float DeltaTime);
+
+	/// Sweep every projectile from its previous position into SweepHits, on the game thread or on workers.
+	void Sweep(bool InParallel);
+
+	/// Sweep a single projectile on the calling thread.
+	bool SweepProjectile(int32 Index, FHitResult& OutHit) const;
+
+	/// Start an async sweep for every projectile. The results are collected next tick.
+	void IssueAsyncSweeps();
+
+	/// Read back the sweeps of IssueAsyncSweeps into SweepHits. Sweeps that aren't done yet run synchronously.
+	/// Returns how many projectiles have a result.
+	int32 CollectAsyncSweeps();
+
+	/// Turn the first Count results of SweepHits into Impacts and find the projectiles that expired.
+	void GatherImpacts(int32 Count);
+
+	/// Apply the frame's impacts in launch order and remove the projectiles that hit or expired.
+	void Resolve();
+
+	/// Physics impulse, and damage with authority, for one impact.
+	void ApplyImpact(const FProjectileImpact& Impact, bool HasAuthority) const;
+
+	/// Move the visuals to the simulated positions.
+	void UpdateVisuals();
+
+	AProjectileBase* AcquireVisual(TSubclassOf<AProjectileBase> VisualClass, const FVector& Location, const FRotator& Rotation);
+
+	void ReleaseVisual(AProjectileBase* Visual);
+
+	FProjectileSimState State;
+
+	/// Positions before this frame's integration, where the sweeps start.
+	TArray<FVector> PreviousPositions;
+
+	/// Sweep result per projectile index.
+	TArray<FHitResult> SweepHits;
+	TArray<uint8> SweepDidHit;
+
+	/// Async sweeps in flight, by projectile index, with the id they were issued for.
+	TArray<TPair<FTraceHandle, uint32>> PendingSweeps;
+
+	/// Projectiles that hit something this frame.
+	TArray<FProjectileImpact> Impacts;
+
+	/// Projectiles to remove this frame.
+	TArray<int32> Finished;
+
+	/// Hidden visual actors ready for reuse.
+	UPROPERTY()
+	TArray<TObjectPtr<AProjectileBase>> FreeVisuals;
+
+	uint32 NextId = 1;
+
+	uint32 NumSweepsLate = 0;
+};
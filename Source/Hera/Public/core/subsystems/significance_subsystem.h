@@ -0,0 +1,99 @@
+// Copyright Final Fall Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "significance_subsystem.generated.h"
+
+class ACharacterBase;
+
+/// How much a character matters to the local player, most to least.
+UENUM(BlueprintType)
+enum class ESignificance : uint8
+{
+	/// Locally controlled. Never throttled.
+	Critical,
+
+	/// The closest and largest on screen, up to Hera.Significance.MaxHigh of them.
+	High,
+
+	/// The next Hera.Significance.MaxMedium.
+	Medium,
+
+	/// Everything else in range, and anything not rendered lately.
+	Low,
+
+	/// Past Hera.Significance.CullDistance.
+	Culled,
+};
+
+/// What a character of one significance gets to update.
+struct HERA_API FSignificanceBudget
+{
+	/// Actor tick interval in seconds. 0 ticks every frame.
+	float TickInterval = 0.0f;
+
+	/// Skeletal mesh tick interval in seconds, which throttles the animation update.
+	float AnimationTickInterval = 0.0f;
+
+	/// Floating healthbar tick interval in seconds. Negative hides it.
+	float HealthbarTickInterval = 0.0f;
+
+	bool PlayFireSound = true;
+	bool PlayFireAnimation = true;
+
+	static const FSignificanceBudget& Get(ESignificance Significance);
+};
+
+/// Ranks every character by how much it matters to the local player and throttles the ones that matter less.
+///
+/// NOTES:
+// - Characters register themselves in BeginPlay and leave in EndPlay.
+// - Every Hera.Significance.UpdateInterval the characters are ranked by screen size, their capsule radius over the
+//   distance to the view, and sorted into ESignificance. Characters not rendered lately go straight to Low.
+// - A character's budget is applied by ACharacterBase::SetSignificance, and only when its significance changes.
+// - Never created on a dedicated server, where nothing is seen.
+UCLASS()
+class HERA_API USignificanceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void Register(ACharacterBase* Character);
+
+	void Unregister(ACharacterBase* Character);
+
+	int32 GetNumRegistered() const { return Characters.Num(); }
+
+	/// Re-rank every character from this view now.
+	void Update(const FVector& ViewLocation, float FOVDegrees);
+
+	/// Whether throttling is on.
+	static bool IsEnabled();
+
+	//~ UTickableWorldSubsystem
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual void Deinitialize() override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/// Where the first local player is looking from. False without one.
+	bool GetViewPoint(FVector& OutLocation, float& OutFOVDegrees) const;
+
+	TArray<TWeakObjectPtr<ACharacterBase>> Characters;
+
+	/// Seconds until the next Update.
+	float TimeUntilUpdate = 0.0f;
+
+	/// Scratch for Update, kept to avoid reallocating.
+	struct FRankedCharacter
+	{
+		ACharacterBase* Character;
+		float ScreenSize;
+	};
+	TArray<FRankedCharacter> Ranked;
+};
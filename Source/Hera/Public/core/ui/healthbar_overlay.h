@@ -0,0 +1,53 @@
+// Copyright Final Fall Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Widgets/SLeafWidget.h"
+
+/// One healthbar to draw, already projected. Amounts are fractions of the whole bar.
+struct HERA_API FHealthbarDrawData
+{
+	/// Centre of the bar's bottom edge, in viewport pixels.
+	FVector2f Position = FVector2f::ZeroVector;
+
+	/// Shrinks bars of characters further away.
+	float Scale = 1.0f;
+
+	float Health = 0.0f;
+	float Armor = 0.0f;
+	float Shields = 0.0f;
+	float OverHealth = 0.0f;
+	float OverArmor = 0.0f;
+};
+
+/// Draws every floating healthbar in one paint pass over the game viewport. UHealthbarSubsystem fills it every frame.
+class HERA_API SHealthbarOverlay : public SLeafWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SHealthbarOverlay) {}
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs);
+
+	/// Replace the bars drawn from the next paint on.
+	void SetHealthbars(TArray<FHealthbarDrawData>&& NewHealthbars);
+
+	//~ SWidget
+	virtual int32 OnPaint(
+		const FPaintArgs& Args,
+		const FGeometry& AllottedGeometry,
+		const FSlateRect& MyCullingRect,
+		FSlateWindowElementList& OutDrawElements,
+		int32 LayerId,
+		const FWidgetStyle& InWidgetStyle,
+		bool bParentEnabled
+	) const override;
+
+	virtual FVector2D ComputeDesiredSize(float LayoutScaleMultiplier) const override;
+
+private:
+	TArray<FHealthbarDrawData> Healthbars;
+
+	const FSlateBrush* Brush = nullptr;
+};
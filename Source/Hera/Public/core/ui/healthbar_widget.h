@@ -8,6 +8,39 @@
 
 class ACharacterBase;
 
+/// Everything a healthbar shows of a character's life pool, read at once.
+USTRUCT(BlueprintType)
+struct HERA_API FHealthbarSnapshot
+{
+   GENERATED_BODY()
+
+   UPROPERTY(BlueprintReadOnly, Category="Hera")
+   float Health = 0.0f;
+
+   UPROPERTY(BlueprintReadOnly, Category="Hera")
+   float MaxHealth = 0.0f;
+
+   UPROPERTY(BlueprintReadOnly, Category="Hera")
+   float Shields = 0.0f;
+
+   UPROPERTY(BlueprintReadOnly, Category="Hera")
+   float MaxShields = 0.0f;
+
+   UPROPERTY(BlueprintReadOnly, Category="Hera")
+   float Armor = 0.0f;
+
+   UPROPERTY(BlueprintReadOnly, Category="Hera")
+   float MaxArmor = 0.0f;
+
+   UPROPERTY(BlueprintReadOnly, Category="Hera")
+   float OverHealth = 0.0f;
+
+   UPROPERTY(BlueprintReadOnly, Category="Hera")
+   float OverArmor = 0.0f;
+
+   static FHealthbarSnapshot FromCharacter(const ACharacterBase* Character);
+};
+
 /// TODO: Zach - 4/24/23
 // - Figure out why the OwningCharacter is null when referenced by the UMG graph
 
@@ -26,6 +59,12 @@ public:
    UFUNCTION(BlueprintCallable, Category="Hera")
    void SetOwningCharacter(ACharacterBase* NewOwningCharacter);
 
+   /// Show a whole life pool in one call. UHealthbarSubsystem calls it at most once per flush, when the character's
+   /// life pool changed. Overriding it in the widget Blueprint replaces the per-value events below, which the native
+   /// version calls one by one.
+   UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category="Hera")
+   void ApplySnapshot(const FHealthbarSnapshot& Snapshot);
+
    UFUNCTION(BlueprintImplementableEvent, BlueprintCallable, Category="Hera")
 	void SetMaxHealth(float MaxHealth);
 